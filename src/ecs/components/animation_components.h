@@ -1,16 +1,49 @@
 #pragma once
 #include <SDL.h>
+#include <cstdint>
+#include <string>
 #include <utils/animation.h>
+#include <utils/animation_playback_pool.h>
+#include <vector>
 
+// The playback slot is released only when the component is destroyed. Replacing or patching the component with a
+// new slot leaks the old one, so the clip is switched with AnimationPlaybackPool::SetClip instead.
 struct AnimationComponent
 {
-    Animation animation; // Frames of the animation.
-    float currentFrameTime = 0; // Time in seconds from the start of the current frame.
-    size_t currentFrameIndex = 0; // Index of the current frame.
-    bool isPlaying = false; // Is the animation playing.
-    bool loop = true; // Should the animation loop.
+    const Animation* clip = nullptr; // Immutable frames owned by the ResourceManager. Shared by all entities.
+    // Frame and time of the playback in the AnimationPlaybackPool.
+    uint32_t playbackSlot = AnimationPlaybackPool::invalidSlot;
     SDL_RendererFlip flip = SDL_FLIP_NONE; // Flip of the animation.
-    float speedFactor = 1.0f;
 public: ///////////////////////////////////////////////// Helpers. ///////////////////////////////////////////////
-    inline glm::vec2 GetHitboxSize() const { return glm::vec2(animation.hitboxRect->w, animation.hitboxRect->h); }
+    inline glm::vec2 GetHitboxSize() const { return glm::vec2(clip->hitboxRect->w, clip->hitboxRect->h); }
+};
+
+// Clips of the entity switched by the transition rules. The AnimationComponent and the hitbox are touched only when
+// the state changes, not every frame.
+struct AnimationStateMachineComponent
+{
+    enum class Condition
+    {
+        SpeedAbove, // Speed of the body is greater than the threshold.
+        SpeedBelow, // Speed of the body is less than the threshold.
+    };
+
+    struct State
+    {
+        std::string name; // Tag of the animation.
+        const Animation* clip = nullptr; // Owned by the ResourceManager.
+        bool isSpeedDriven = false; // Playback speed follows the speed of the body.
+    };
+
+    struct Transition
+    {
+        size_t fromState;
+        size_t toState;
+        Condition condition;
+        float threshold; // In Box2D units per second.
+    };
+
+    std::vector<State> states;
+    std::vector<Transition> transitions; // Checked in order. The first matching one is taken.
+    size_t currentState = 0;
 };
\ No newline at end of file
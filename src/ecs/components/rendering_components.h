@@ -40,6 +40,12 @@ struct TileComponent
     ColorName colorName = ColorName::Blue; // Color if the texture is not available.
 };
 
+// Tile without the Box2D body. Decorative layers never move and never collide, so the position is stored here.
+struct RenderOnlyTileComponent
+{
+    glm::vec2 centerWorld = {0, 0};
+};
+
 struct DebugVisualObjectComponent
 {};
 
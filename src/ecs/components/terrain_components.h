@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <ecs/components/rendering_components.h>
+#include <glm/glm.hpp>
+#include <memory>
+#include <utils/sdl/sdl_RAII.h>
+#include <vector>
+
+// Static body with chain loops which outline one chunk of the TerrainBitmap.
+struct TerrainChunkComponent
+{
+    size_t chunkIndex = 0; // Index of the chunk in the TerrainBitmap.
+};
+
+// Tile which is loaded as one body and subdivided into quadrants only when an explosion overlaps it.
+struct QuadTreeTileComponent
+{
+    std::shared_ptr<SDLSurfaceRAII> surface; // Surface of the tile texture. Used to skip invisible quadrants.
+};
+
+// Disconnected piece of the terrain which falls as one body with a box fixture per tile.
+struct CompoundTilesComponent
+{
+    struct Part
+    {
+        TileComponent tile;
+        glm::vec2 offsetWorld; // Offset of the tile center from the body position when the body angle is zero.
+    };
+    std::vector<Part> parts;
+};
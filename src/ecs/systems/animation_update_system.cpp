@@ -3,75 +3,67 @@
 #include <ecs/components/physics_components.h>
 #include <ecs/components/player_components.h>
 
-AnimationUpdateSystem::AnimationUpdateSystem(entt::registry& registry, ResourceManager& resourceManager)
+AnimationUpdateSystem::AnimationUpdateSystem(entt::registry& registry, AnimationPlaybackPool& playbackPool)
   : registry(registry), gameState(registry.get<GameOptions>(registry.view<GameOptions>().front())),
-    resourceManager(resourceManager), box2dBodyTuner(registry)
-{}
+    playbackPool(playbackPool), box2dBodyTuner(registry)
+{
+    registry.on_destroy<AnimationComponent>().connect<&AnimationUpdateSystem::OnAnimationComponentDestroyed>(this);
+}
+
+AnimationUpdateSystem::~AnimationUpdateSystem()
+{
+    registry.on_destroy<AnimationComponent>().disconnect(this);
+}
 
 void AnimationUpdateSystem::Update(float deltaTime)
 {
-    UpdateAnimationProgressForAllEntities(deltaTime);
-    UpdatePlayerAnimationDirectionAndSpeed();
+    playbackPool.Advance(deltaTime);
+    UpdateAnimationStateMachines();
+    UpdatePlayerAnimationDirection();
 }
 
-void AnimationUpdateSystem::UpdateAnimationProgressForAllEntities(float deltaTime)
+void AnimationUpdateSystem::UpdateAnimationStateMachines()
 {
-    auto view = registry.view<AnimationComponent>();
+    auto view = registry.view<AnimationComponent, AnimationStateMachineComponent, PhysicsComponent>();
 
     for (auto entity : view)
     {
-        auto& animationInfo = view.get<AnimationComponent>(entity);
+        const auto& [animationInfo, stateMachine, physicsInfo] =
+            view.get<AnimationComponent, AnimationStateMachineComponent, PhysicsComponent>(entity);
 
-        if (animationInfo.isPlaying)
-        {
-            animationInfo.currentFrameTime += deltaTime * animationInfo.speedFactor * 0.5;
+        auto vel = physicsInfo.bodyRAII->GetBody()->GetLinearVelocity();
+        float speed = glm::length(glm::vec2(vel.x, vel.y));
 
-            // TODO1: Unify using the modulo operator in interface.
-            auto safeIndex = animationInfo.currentFrameIndex % animationInfo.animation.frames.size();
+        for (const auto& transition : stateMachine.transitions)
+        {
+            if (transition.fromState != stateMachine.currentState)
+                continue;
 
-            if (animationInfo.currentFrameTime >= animationInfo.animation.frames[safeIndex].duration)
+            using Condition = AnimationStateMachineComponent::Condition;
+            const bool isConditionMet = transition.condition == Condition::SpeedAbove ? speed > transition.threshold
+                                                                                        : speed < transition.threshold;
+            if (isConditionMet)
             {
-                animationInfo.currentFrameTime -= animationInfo.animation.frames[safeIndex].duration;
-                animationInfo.currentFrameIndex =
-                    (animationInfo.currentFrameIndex + 1) % animationInfo.animation.frames.size();
-
-                // Stop the animation if it's not looped and the last frame is reached.
-                if (!animationInfo.loop && animationInfo.currentFrameIndex == 0)
-                {
-                    animationInfo.isPlaying = false;
-                }
+                EnterState(entity, animationInfo, stateMachine, transition.toState);
+                break;
             }
         }
+
+        // Change the animation speed based on the body speed.
+        if (stateMachine.states[stateMachine.currentState].isSpeedDriven)
+            playbackPool.SetSpeedFactor(animationInfo.playbackSlot, std::min(speed, 2.5f)); // Limit max speed.
+        else
+            playbackPool.SetSpeedFactor(animationInfo.playbackSlot, 1.0f);
     }
 }
 
-void AnimationUpdateSystem::UpdatePlayerAnimationDirectionAndSpeed()
+void AnimationUpdateSystem::UpdatePlayerAnimationDirection()
 {
-    auto view = registry.view<AnimationComponent, PlayerComponent, PhysicsComponent>();
+    auto view = registry.view<AnimationComponent, PlayerComponent>();
 
     for (auto entity : view)
     {
-        const auto& [animationInfo, playerInfo, physicsInfo] =
-            view.get<AnimationComponent, PlayerComponent, PhysicsComponent>(entity);
-
-        // Change the animation speed based on the player's speed.
-        auto body = physicsInfo.bodyRAII->GetBody();
-        auto vel = body->GetLinearVelocity();
-        float speed = glm::length(glm::vec2(vel.x, vel.y));
-
-        if (speed > 0.1f)
-        {
-            animationInfo.animation = resourceManager.GetAnimation("player", "Run");
-            animationInfo.speedFactor = std::min(speed, 2.5f); // Limit max speed.
-        }
-        else
-        {
-            animationInfo.animation = resourceManager.GetAnimation("player", "Idle");
-            animationInfo.speedFactor = 1.0f;
-        }
-
-        // Update shape because the animation might have changed.
-        box2dBodyTuner.ApplyOption(entity, Box2dBodyOptions::Hitbox{animationInfo.GetHitboxSize()});
+        const auto& [animationInfo, playerInfo] = view.get<AnimationComponent, PlayerComponent>(entity);
 
         // Change the animation direction based on the player's direction.
         if (playerInfo.weaponDirection.x < 0)
@@ -79,4 +71,25 @@ void AnimationUpdateSystem::UpdatePlayerAnimationDirectionAndSpeed()
         else if (playerInfo.weaponDirection.x > 0)
             animationInfo.flip = SDL_FLIP_NONE;
     }
-}
\ No newline at end of file
+}
+
+void AnimationUpdateSystem::OnAnimationComponentDestroyed(entt::registry& changedRegistry, entt::entity entity)
+{
+    playbackPool.Release(changedRegistry.get<AnimationComponent>(entity).playbackSlot);
+}
+
+void AnimationUpdateSystem::EnterState(
+    entt::entity entity, AnimationComponent& animationInfo, AnimationStateMachineComponent& stateMachine,
+    size_t stateIndex)
+{
+    const glm::vec2 previousHitboxSize = animationInfo.GetHitboxSize();
+
+    stateMachine.currentState = stateIndex;
+    animationInfo.clip = stateMachine.states[stateIndex].clip;
+    playbackPool.SetClip(animationInfo.playbackSlot, *animationInfo.clip);
+
+    // Rebuilding of the fixtures is expensive. Skip it if the clips share the hitbox.
+    const glm::vec2 hitboxSize = animationInfo.GetHitboxSize();
+    if (hitboxSize != previousHitboxSize)
+        box2dBodyTuner.ApplyOption(entity, Box2dBodyOptions::Hitbox{hitboxSize});
+}
@@ -1,18 +1,27 @@
 #pragma once
 #include "utils/box2d/box2d_body_tuner.h"
+#include <ecs/components/animation_components.h>
 #include <entt/entt.hpp>
+#include <utils/animation_playback_pool.h>
 #include <utils/game_options.h>
-#include <utils/resources/resource_manager.h>
 
 class AnimationUpdateSystem
 {
     entt::registry& registry;
     GameOptions& gameState;
-    ResourceManager& resourceManager;
+    AnimationPlaybackPool& playbackPool;
     Box2dBodyTuner box2dBodyTuner;
 public:
-    AnimationUpdateSystem(entt::registry& registry, ResourceManager& resourceManager);
-    void UpdateAnimationProgressForAllEntities(float deltaTime);
-    void UpdatePlayerAnimationDirectionAndSpeed();
+    AnimationUpdateSystem(entt::registry& registry, AnimationPlaybackPool& playbackPool);
+    ~AnimationUpdateSystem();
+    AnimationUpdateSystem(const AnimationUpdateSystem&) = delete;
+    AnimationUpdateSystem& operator=(const AnimationUpdateSystem&) = delete;
+    void UpdateAnimationStateMachines();
+    void UpdatePlayerAnimationDirection();
     void Update(float deltaTime);
+private:
+    void OnAnimationComponentDestroyed(entt::registry& changedRegistry, entt::entity entity);
+    void EnterState(
+        entt::entity entity, AnimationComponent& animationInfo, AnimationStateMachineComponent& stateMachine,
+        size_t stateIndex);
 };
\ No newline at end of file
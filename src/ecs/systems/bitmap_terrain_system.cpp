@@ -0,0 +1,100 @@
+#include "bitmap_terrain_system.h"
+#include <ecs/components/physics_components.h>
+#include <ecs/components/terrain_components.h>
+#include <my_cpp_utils/config.h>
+#include <utils/logger.h>
+#include <utils/terrain/terrain_contours.h>
+
+BitmapTerrainSystem::BitmapTerrainSystem(entt::registry& registry, BaseObjectsFactory& baseObjectsFactory)
+  : registry(registry), gameState(registry.get<GameOptions>(registry.view<GameOptions>().front())),
+    baseObjectsFactory(baseObjectsFactory), bodyTuner(registry)
+{}
+
+void BitmapTerrainSystem::Update()
+{
+    auto terrainBitmap = gameState.levelOptions.terrainBitmap;
+    if (!terrainBitmap)
+        return;
+
+    // Bodies of the previous level are destroyed with the Box2D world on the map reload.
+    if (collidersOwner.lock() != terrainBitmap)
+    {
+        collidersOwner = terrainBitmap;
+        chunkEntities.assign(terrainBitmap->GetChunksCount(), entt::null);
+        CreateIndestructibleColliders(*terrainBitmap);
+    }
+
+    size_t rebuiltChunks = 0;
+    for (size_t chunkIndex = 0; chunkIndex < terrainBitmap->GetChunksCount(); ++chunkIndex)
+    {
+        auto& chunk = terrainBitmap->GetChunk(chunkIndex);
+        if (!chunk.isCollidersDirty)
+            continue;
+
+        RebuildChunkColliders(*terrainBitmap, chunkIndex);
+        chunk.isCollidersDirty = false;
+        rebuiltChunks++;
+    }
+
+    if (rebuiltChunks > 0)
+        MY_LOG(debug, "[BitmapTerrainSystem] Rebuilt colliders of {} chunks", rebuiltChunks);
+}
+
+void BitmapTerrainSystem::RebuildChunkColliders(TerrainBitmap& terrainBitmap, size_t chunkIndex)
+{
+    const SDL_Rect chunkRectPixels = terrainBitmap.GetChunkRectPixels(chunkIndex);
+    auto loopsWorld = TraceLoopsWorld(terrainBitmap, chunkRectPixels, TerrainBitmap::Pixel::Destructible);
+
+    auto& chunkEntity = chunkEntities[chunkIndex];
+    if (!registry.valid(chunkEntity))
+    {
+        // Nothing to collide with. Don't create the body for the empty chunk.
+        if (loopsWorld.empty())
+            return;
+
+        glm::vec2 chunkTopLeftWorld = terrainBitmap.PixelToWorld(glm::vec2(chunkRectPixels.x, chunkRectPixels.y));
+        glm::vec2 chunkSizeWorld(chunkRectPixels.w, chunkRectPixels.h);
+        chunkEntity =
+            baseObjectsFactory.SpawnTerrainChunk(chunkTopLeftWorld + chunkSizeWorld / 2.0f, chunkSizeWorld, chunkIndex);
+    }
+
+    bodyTuner.SetChainLoops(chunkEntity, loopsWorld);
+}
+
+void BitmapTerrainSystem::CreateIndestructibleColliders(const TerrainBitmap& terrainBitmap)
+{
+    // Whole bitmap is traced at once. So contours are not cut by the chunk borders.
+    const glm::ivec2 sizePixels = terrainBitmap.GetSizePixels();
+    const SDL_Rect bitmapRectPixels = {0, 0, sizePixels.x, sizePixels.y};
+    auto loopsWorld = TraceLoopsWorld(terrainBitmap, bitmapRectPixels, TerrainBitmap::Pixel::Indestructible);
+    if (loopsWorld.empty())
+        return;
+
+    glm::vec2 bitmapTopLeftWorld = terrainBitmap.PixelToWorld(glm::vec2(0, 0));
+    glm::vec2 bitmapSizeWorld(sizePixels);
+    auto entity =
+        baseObjectsFactory.SpawnIndestructibleTerrain(bitmapTopLeftWorld + bitmapSizeWorld / 2.0f, bitmapSizeWorld);
+    bodyTuner.SetChainLoops(entity, loopsWorld);
+
+    MY_LOG(info, "[BitmapTerrainSystem] Indestructible terrain is outlined by {} chain loops", loopsWorld.size());
+}
+
+std::vector<std::vector<glm::vec2>> BitmapTerrainSystem::TraceLoopsWorld(
+    const TerrainBitmap& terrainBitmap, const SDL_Rect& rectPixels, TerrainBitmap::Pixel solidPixel)
+{
+    const auto& epsilon = utils::GetConfig<float, "BitmapTerrainSystem.contourSimplificationEpsilon">();
+
+    std::vector<std::vector<glm::vec2>> loopsWorld;
+    for (const auto& contourPixels : utils::TraceTerrainContours(terrainBitmap, rectPixels, solidPixel))
+    {
+        auto simplifiedPixels = utils::SimplifyClosedPolyline(contourPixels, epsilon);
+        if (simplifiedPixels.empty())
+            continue;
+
+        auto& loopWorld = loopsWorld.emplace_back();
+        for (const auto& pointPixels : simplifiedPixels)
+            loopWorld.push_back(terrainBitmap.PixelToWorld(pointPixels));
+    }
+
+    return loopsWorld;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <entt/entt.hpp>
+#include <memory>
+#include <utils/box2d/box2d_body_tuner.h>
+#include <utils/coordinates_transformer.h>
+#include <utils/factories/base_objects_factory.h>
+#include <utils/game_options.h>
+#include <utils/terrain/terrain_bitmap.h>
+#include <vector>
+
+// Keeps Box2D colliders of the TerrainBitmap in sync with its pixels. Only dirty chunks are rebuilt.
+// Indestructible pixels never change. They are outlined once per level by one static body.
+class BitmapTerrainSystem
+{
+    entt::registry& registry;
+    GameOptions& gameState;
+    BaseObjectsFactory& baseObjectsFactory;
+    Box2dBodyTuner bodyTuner;
+    std::weak_ptr<TerrainBitmap> collidersOwner; // Bitmap whose colliders are created.
+    std::vector<entt::entity> chunkEntities; // Index is the chunk index. entt::null if the chunk has no body yet.
+public:
+    BitmapTerrainSystem(entt::registry& registry, BaseObjectsFactory& baseObjectsFactory);
+    // Should be called after all systems which may carve the terrain and before the next physics step.
+    void Update();
+private:
+    void RebuildChunkColliders(TerrainBitmap& terrainBitmap, size_t chunkIndex);
+    void CreateIndestructibleColliders(const TerrainBitmap& terrainBitmap);
+    // Closed contours of the `solidPixel` pixels inside the rect. Simplified and converted to the world coordinates.
+    std::vector<std::vector<glm::vec2>> TraceLoopsWorld(
+        const TerrainBitmap& terrainBitmap, const SDL_Rect& rectPixels, TerrainBitmap::Pixel solidPixel);
+};
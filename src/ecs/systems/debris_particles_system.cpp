@@ -0,0 +1,119 @@
+#include "debris_particles_system.h"
+#include <ecs/components/physics_components.h>
+#include <ecs/components/rendering_components.h>
+#include <my_cpp_utils/config.h>
+#include <utils/logger.h>
+
+DebrisParticlesSystem::DebrisParticlesSystem(entt::registry& registry, DebrisParticlesPool& particlesPool)
+  : registry(registry), gameState(registry.get<GameOptions>(registry.view<GameOptions>().front())),
+    particlesPool(particlesPool), coordinatesTransformer(registry)
+{
+    registry.on_construct<PhysicsComponent>().connect<&DebrisParticlesSystem::OnPhysicsComponentConstructed>(this);
+    registry.on_destroy<PhysicsComponent>().connect<&DebrisParticlesSystem::OnTileLeftTerrain>(this);
+    // Tiles thrown by the explosions become dynamic Box2D debris. They are not a part of the terrain anymore.
+    registry.on_construct<ExplostionParticlesComponent>().connect<&DebrisParticlesSystem::OnTileLeftTerrain>(this);
+}
+
+DebrisParticlesSystem::~DebrisParticlesSystem()
+{
+    registry.on_construct<PhysicsComponent>().disconnect(this);
+    registry.on_destroy<PhysicsComponent>().disconnect(this);
+    registry.on_construct<ExplostionParticlesComponent>().disconnect(this);
+}
+
+void DebrisParticlesSystem::Update(float deltaTime)
+{
+    // Particles and the grid belong to the level. Reset them after the map reload.
+    if (occupancyGridOwner.lock() != gameState.physicsWorld)
+    {
+        occupancyGridOwner = gameState.physicsWorld;
+        particlesPool.Clear();
+        RebuildOccupancyGrid();
+    }
+
+    for (auto entity : constructedBodies)
+        StampStaticTile(entity);
+    constructedBodies.clear();
+
+    if (particlesPool.GetCount() == 0)
+        return;
+
+    const glm::vec2 gravityWorld = coordinatesTransformer.PhysicsToWorld(gameState.gravity);
+    particlesPool.Integrate(deltaTime, gravityWorld, utils::GetConfig<float, "DebrisParticlesSystem.airDamping">());
+
+    auto terrainBitmap = gameState.levelOptions.terrainBitmap;
+    auto isSolid = [&](const glm::vec2& posWorld)
+    {
+        if (occupancyGrid && occupancyGrid->IsOccupied(posWorld))
+            return true;
+        if (!terrainBitmap)
+            return false;
+
+        const glm::ivec2 pixel = terrainBitmap->WorldToPixel(posWorld);
+        return terrainBitmap->GetPixel(pixel.x, pixel.y) != TerrainBitmap::Pixel::Empty;
+    };
+    particlesPool.Collide(
+        isSolid, utils::GetConfig<float, "DebrisParticlesSystem.restitution">(),
+        utils::GetConfig<float, "DebrisParticlesSystem.friction">());
+
+    particlesPool.UpdateLifetimes(deltaTime);
+}
+
+void DebrisParticlesSystem::RebuildOccupancyGrid()
+{
+    occupancyGrid.reset();
+    stampedTiles.clear();
+    constructedBodies.clear();
+
+    const auto& levelBounds = gameState.levelOptions.levelBox2dBounds;
+    if (levelBounds.min.x >= levelBounds.max.x || levelBounds.min.y >= levelBounds.max.y)
+        return;
+
+    occupancyGrid = std::make_unique<OccupancyGrid>(
+        coordinatesTransformer.PhysicsToWorld(levelBounds.min), coordinatesTransformer.PhysicsToWorld(levelBounds.max),
+        utils::GetConfig<float, "DebrisParticlesSystem.occupancyCellSize">());
+
+    for (auto entity : registry.view<TileComponent, PhysicsComponent, CollidableComponent>())
+        StampStaticTile(entity);
+
+    MY_LOG(debug, "[DebrisParticlesSystem] Occupancy grid rebuilt. Static tiles count {}", stampedTiles.size());
+}
+
+void DebrisParticlesSystem::StampStaticTile(entt::entity entity)
+{
+    if (!occupancyGrid || !registry.valid(entity) || stampedTiles.contains(entity))
+        return;
+
+    if (!registry.all_of<TileComponent, PhysicsComponent, CollidableComponent>(entity))
+        return;
+
+    // Terrain tiles are static and not rotated. Dynamic bodies are not a part of the terrain.
+    auto body = registry.get<PhysicsComponent>(entity).bodyRAII->GetBody();
+    if (body->GetType() != b2_staticBody)
+        return;
+
+    const glm::vec2 centerWorld = coordinatesTransformer.PhysicsToWorld(body->GetPosition());
+    const glm::vec2 halfSizeWorld = registry.get<TileComponent>(entity).sizeWorld / 2.0f;
+    const glm::vec2 minWorld = centerWorld - halfSizeWorld;
+    const glm::vec2 maxWorld = centerWorld + halfSizeWorld;
+    occupancyGrid->AddRect(minWorld, maxWorld);
+    stampedTiles.emplace(entity, std::make_pair(minWorld, maxWorld));
+}
+
+void DebrisParticlesSystem::OnPhysicsComponentConstructed(
+    [[maybe_unused]] entt::registry& changedRegistry, entt::entity entity)
+{
+    // Other components of the tile are emplaced after the body. So the tile is checked on the next update.
+    constructedBodies.push_back(entity);
+}
+
+void DebrisParticlesSystem::OnTileLeftTerrain([[maybe_unused]] entt::registry& changedRegistry, entt::entity entity)
+{
+    auto it = stampedTiles.find(entity);
+    if (it == stampedTiles.end())
+        return;
+
+    if (occupancyGrid)
+        occupancyGrid->RemoveRect(it->second.first, it->second.second);
+    stampedTiles.erase(it);
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+#include <memory>
+#include <unordered_map>
+#include <utils/coordinates_transformer.h>
+#include <utils/game_options.h>
+#include <utils/particles/debris_particles_pool.h>
+#include <utils/particles/occupancy_grid.h>
+#include <vector>
+
+// Moves the visual-only debris of the DebrisParticlesPool. Particles collide with the static terrain only: the
+// occupancy grid of the static tiles and the TerrainBitmap. The grid follows the tiles through the EnTT signals.
+class DebrisParticlesSystem
+{
+    entt::registry& registry;
+    GameOptions& gameState;
+    DebrisParticlesPool& particlesPool;
+    CoordinatesTransformer coordinatesTransformer;
+    std::weak_ptr<b2World> occupancyGridOwner; // Physics world whose static tiles are stamped into the grid.
+    std::unique_ptr<OccupancyGrid> occupancyGrid; // Empty if the level bounds are unknown.
+    std::unordered_map<entt::entity, std::pair<glm::vec2, glm::vec2>> stampedTiles; // Min and max of the rects.
+    std::vector<entt::entity> constructedBodies; // Stamped on the next update if they are static tiles.
+public:
+    DebrisParticlesSystem(entt::registry& registry, DebrisParticlesPool& particlesPool);
+    ~DebrisParticlesSystem();
+    DebrisParticlesSystem(const DebrisParticlesSystem&) = delete;
+    DebrisParticlesSystem& operator=(const DebrisParticlesSystem&) = delete;
+    // Should be called after the destructions of the frame are flushed.
+    void Update(float deltaTime);
+private:
+    void RebuildOccupancyGrid();
+    void StampStaticTile(entt::entity entity);
+    void OnPhysicsComponentConstructed(entt::registry& changedRegistry, entt::entity entity);
+    // Body is destroyed or thrown by an explosion. Its rect is removed from the grid.
+    void OnTileLeftTerrain(entt::registry& changedRegistry, entt::entity entity);
+};
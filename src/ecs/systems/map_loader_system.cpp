@@ -3,22 +3,24 @@
 #include <SDL_image.h>
 #include <box2d/b2_math.h>
 #include <ecs/components/physics_components.h>
+#include <ecs/components/rendering_components.h>
 #include <fstream>
 #include <my_cpp_utils/config.h>
 #include <my_cpp_utils/math_utils.h>
 #include <utils/box2d/box2d_glm_operators.h>
 #include <utils/entt/entt_registry_wrapper.h>
-#include <utils/factories/box2d_body_creator.h>
 #include <utils/logger.h>
 #include <utils/math_utils.h>
 #include <utils/sdl/sdl_texture_process.h>
 
 MapLoaderSystem::MapLoaderSystem(
-    EnttRegistryWrapper& registryWrapper, ResourceManager& resourceManager, Box2dEnttContactListener& contactListener,
-    GameObjectsFactory& gameObjectsFactory, BaseObjectsFactory& baseObjectsFactory)
-  : registryWrapper(registryWrapper), registry(registryWrapper.GetRegistry()), resourceManager(resourceManager),
-    contactListener(contactListener), gameState(registry.get<GameOptions>(registry.view<GameOptions>().front())),
-    gameObjectsFactory(gameObjectsFactory), baseObjectsFactory(baseObjectsFactory), coordinatesTransformer(registry)
+    EnttRegistryWrapper& registryWrapper, EnttCommandBuffer& commandBuffer, ResourceManager& resourceManager,
+    Box2dEnttContactListener& contactListener, GameObjectsFactory& gameObjectsFactory,
+    BaseObjectsFactory& baseObjectsFactory)
+  : registryWrapper(registryWrapper), registry(registryWrapper.GetRegistry()), commandBuffer(commandBuffer),
+    resourceManager(resourceManager), contactListener(contactListener),
+    gameState(registry.get<GameOptions>(registry.view<GameOptions>().front())), gameObjectsFactory(gameObjectsFactory),
+    baseObjectsFactory(baseObjectsFactory), coordinatesTransformer(registry)
 {}
 
 void MapLoaderSystem::LoadMap(const LevelInfo& levelInfo)
@@ -35,10 +37,13 @@ void MapLoaderSystem::LoadMap(const LevelInfo& levelInfo)
     nlohmann::json mapJson;
     file >> mapJson;
 
-    // Load tileset texture and surface. Surface is used to search for invisible tiles.
+    // Load tileset texture and surface. Surface is used to search for invisible tiles. Tileset may be a part of the
+    // atlas page, so rects of the tiles are calculated inside of the tileset rect.
     std::filesystem::path tilesetPath = ReadPathToTileset(mapJson);
-    tilesetTexture = resourceManager.GetTexture(tilesetPath);
-    tilesetSurface = resourceManager.GetSurface(tilesetPath);
+    AtlasRegion tilesetRegion = resourceManager.GetAtlasRegion(tilesetPath);
+    tilesetTexture = tilesetRegion.texture;
+    tilesetSurface = tilesetRegion.surface;
+    tilesetRect = tilesetRegion.rect;
 
     // Load background texture.
     gameState.levelOptions.backgroundInfo.texture = resourceManager.GetTexture(levelInfo.backgroundPath);
@@ -52,6 +57,20 @@ void MapLoaderSystem::LoadMap(const LevelInfo& levelInfo)
     miniWidth = tileWidth / colAndRowNumber;
     miniHeight = tileHeight / colAndRowNumber;
 
+    // Destructible terrain may be stored as a pixel occupancy bitmap instead of mini tiles. Indestructible terrain
+    // is stored in the same bitmap to be outlined by a few chain shapes instead of a body per mini tile.
+    if (utils::GetConfig<bool, "MapLoaderSystem.useBitmapTerrain">() ||
+        utils::GetConfig<bool, "MapLoaderSystem.indestructibleTerrainChains">())
+    {
+        // Mini tile (0, 0) is centered at the world origin. So the bitmap starts from its top left corner.
+        glm::vec2 originWorld = -glm::vec2(miniWidth, miniHeight) / 2.0f;
+        int mapWidthPixels = mapJson["width"].get<int>() * tileWidth;
+        int mapHeightPixels = mapJson["height"].get<int>() * tileHeight;
+        auto& chunkSize = utils::GetConfig<int, "MapLoaderSystem.terrainChunkSize">();
+        gameState.levelOptions.terrainBitmap =
+            std::make_shared<TerrainBitmap>(originWorld, mapWidthPixels, mapHeightPixels, chunkSize);
+    }
+
     // Iterate over each tile layer.
     for (const auto& layer : mapJson["layers"])
     {
@@ -163,9 +182,33 @@ void MapLoaderSystem::ParseTile(int tileId, int layerCol, int layerRow, SpawnTil
 {
     auto physicsWorld = gameState.physicsWorld;
 
-    SDL_Rect textureSrcRect = CalculateSrcRect(tileId, tileWidth, tileHeight, tilesetTexture);
+    if (utils::GetConfig<bool, "MapLoaderSystem.useBitmapTerrain">() &&
+        tileOptions.destructibleOption == SpawnTileOption::DesctructibleOption::Destructible)
+    {
+        StampTileToTerrainBitmap(tileId, layerCol, layerRow, TerrainBitmap::Pixel::Destructible);
+        return;
+    }
+
+    // Colliders of the indestructible terrain are built once by the BitmapTerrainSystem.
+    if (utils::GetConfig<bool, "MapLoaderSystem.indestructibleTerrainChains">() &&
+        tileOptions.destructibleOption == SpawnTileOption::DesctructibleOption::Indestructible &&
+        tileOptions.collidableOption == SpawnTileOption::CollidableOption::Collidable)
+    {
+        StampTileToTerrainBitmap(tileId, layerCol, layerRow, TerrainBitmap::Pixel::Indestructible);
+        return;
+    }
+
+    if (utils::GetConfig<bool, "MapLoaderSystem.lazyTileSubdivision">() &&
+        tileOptions.destructibleOption == SpawnTileOption::DesctructibleOption::Destructible)
+    {
+        ParseQuadTreeTile(tileId, layerCol, layerRow, tileOptions);
+        return;
+    }
 
-    Box2dBodyCreator box2dBodyCreator(registry);
+    SDL_Rect textureSrcRect = CalculateSrcRect(tileId, tileWidth, tileHeight, tilesetRect);
+
+    const bool renderOnly = utils::GetConfig<bool, "MapLoaderSystem.renderOnlyDecorativeTiles">() &&
+        tileOptions.collidableOption == SpawnTileOption::CollidableOption::Transparent;
 
     // Create entities for each mini tile inside the tile.
     for (int miniRow = 0; miniRow < colAndRowNumber; ++miniRow)
@@ -187,25 +230,137 @@ void MapLoaderSystem::ParseTile(int tileId, int layerCol, int layerRow, SpawnTil
                 }
             }
 
-            // Create tile entity.
+            // Create tile entity. Decorative tiles don't need the Box2D body.
             float miniTileWorldPositionX = layerCol * tileWidth + miniCol * miniWidth;
             float miniTileWorldPositionY = layerRow * tileHeight + miniRow * miniHeight;
             glm::vec2 miniTileWorldPosition{miniTileWorldPositionX, miniTileWorldPositionY};
             auto textureRect = TextureRect{tilesetTexture, miniTextureSrcRect};
-            auto tileEntity = baseObjectsFactory.SpawnTile(miniTileWorldPosition, miniWidth, textureRect, tileOptions);
+            if (renderOnly)
+            {
+                baseObjectsFactory.SpawnRenderOnlyTile(
+                    miniTileWorldPosition, miniWidth, textureRect, tileOptions.zOrderingType);
+            }
+            else
+            {
+                baseObjectsFactory.SpawnTile(miniTileWorldPosition, miniWidth, textureRect, tileOptions);
+            }
 
             // Update level bounds.
-            auto bodyRAII = registry.get<PhysicsComponent>(tileEntity).bodyRAII;
-            const b2Vec2& bodyPosition = bodyRAII->GetBody()->GetPosition();
+            const b2Vec2 tilePosPhysics = coordinatesTransformer.WorldToPhysics(miniTileWorldPosition);
             auto& levelBounds = gameState.levelOptions.levelBox2dBounds;
-            levelBounds.min = utils::Vec2Min(levelBounds.min, bodyPosition);
-            levelBounds.max = utils::Vec2Max(levelBounds.max, bodyPosition);
+            levelBounds.min = utils::Vec2Min(levelBounds.min, tilePosPhysics);
+            levelBounds.max = utils::Vec2Max(levelBounds.max, tilePosPhysics);
 
             createdTiles++;
         }
     }
 }
 
+void MapLoaderSystem::StampTileToTerrainBitmap(int tileId, int layerCol, int layerRow, TerrainBitmap::Pixel pixelKind)
+{
+    if (!tilesetSurface)
+        throw std::runtime_error("tilesetSurface is nullptr");
+
+    auto& terrainBitmap = *gameState.levelOptions.terrainBitmap;
+    SDL_Rect textureSrcRect = CalculateSrcRect(tileId, tileWidth, tileHeight, tilesetRect);
+
+    // Every visible pixel of the tile becomes a pixel of the terrain.
+    size_t stampedPixels = 0;
+    {
+        SDL_Surface* surface = tilesetSurface->get();
+        SDLSurfaceLockRAII lock(surface);
+        const Uint32* pixels = static_cast<const Uint32*>(surface->pixels);
+        const int pitch = surface->pitch / 4; // pitch is in bytes, so divide by 4 to get the number of pixels.
+
+        for (int row = 0; row < textureSrcRect.h; ++row)
+        {
+            for (int col = 0; col < textureSrcRect.w; ++col)
+            {
+                Uint32 pixel = pixels[(textureSrcRect.y + row) * pitch + (textureSrcRect.x + col)];
+                Uint8 alpha = (pixel >> surface->format->Ashift) & 0xFF;
+                if (alpha == 0)
+                    continue;
+
+                terrainBitmap.SetPixel(layerCol * tileWidth + col, layerRow * tileHeight + row, pixelKind, pixel);
+                stampedPixels++;
+            }
+        }
+    }
+
+    if (stampedPixels == 0)
+    {
+        invisibleTilesNumber++;
+        return;
+    }
+
+    // Update level bounds with the corners of the tile.
+    glm::vec2 tileTopLeftWorld = terrainBitmap.PixelToWorld(glm::vec2(layerCol * tileWidth, layerRow * tileHeight));
+    auto& levelBounds = gameState.levelOptions.levelBox2dBounds;
+    for (const auto& cornerWorld : {tileTopLeftWorld, tileTopLeftWorld + glm::vec2(tileWidth, tileHeight)})
+    {
+        const b2Vec2 cornerPhysics = coordinatesTransformer.WorldToPhysics(cornerWorld);
+        levelBounds.min = utils::Vec2Min(levelBounds.min, cornerPhysics);
+        levelBounds.max = utils::Vec2Max(levelBounds.max, cornerPhysics);
+    }
+
+    createdTiles++;
+}
+
+void MapLoaderSystem::ParseQuadTreeTile(int tileId, int layerCol, int layerRow, SpawnTileOption tileOptions)
+{
+    if (!tilesetSurface)
+        throw std::runtime_error("tilesetSurface is nullptr");
+
+    SDL_Rect textureSrcRect = CalculateSrcRect(tileId, tileWidth, tileHeight, tilesetRect);
+
+    // Mini tile (0, 0) is centered at the world origin. So the tile starts from the top left corner of its mini tile.
+    glm::vec2 tileTopLeftWorld =
+        glm::vec2(layerCol * tileWidth, layerRow * tileHeight) - glm::vec2(miniWidth, miniHeight) / 2.0f;
+
+    // Fully visible quadrants become one body. Partially visible ones are divided down to the mini tile size.
+    // Explosions subdivide the bodies further. See BaseObjectsFactory::SpawnCraterRingPhysicalEnteties.
+    std::vector<SDL_Rect> nodes = {textureSrcRect};
+    while (!nodes.empty())
+    {
+        SDL_Rect node = nodes.back();
+        nodes.pop_back();
+
+        const TileAlphaCoverage coverage = GetTileAlphaCoverage(tilesetSurface->get(), node);
+        if (!coverage.hasVisiblePixels)
+        {
+            invisibleTilesNumber++;
+            continue;
+        }
+
+        bool isMiniTile = node.w <= miniWidth || node.h <= miniHeight;
+        if (!isMiniTile && coverage.hasTransparentPixels)
+        {
+            int halfWidth = node.w / 2;
+            int halfHeight = node.h / 2;
+            nodes.push_back({node.x, node.y, halfWidth, halfHeight});
+            nodes.push_back({node.x + halfWidth, node.y, node.w - halfWidth, halfHeight});
+            nodes.push_back({node.x, node.y + halfHeight, halfWidth, node.h - halfHeight});
+            nodes.push_back({node.x + halfWidth, node.y + halfHeight, node.w - halfWidth, node.h - halfHeight});
+            continue;
+        }
+
+        glm::vec2 nodeCenterWorld = tileTopLeftWorld + glm::vec2(node.x - textureSrcRect.x, node.y - textureSrcRect.y) +
+            glm::vec2(node.w, node.h) / 2.0f;
+        auto textureRect = TextureRect{tilesetTexture, node};
+        auto tileEntity = baseObjectsFactory.SpawnQuadTreeTile(
+            nodeCenterWorld, glm::vec2(node.w, node.h), textureRect, tilesetSurface, tileOptions);
+
+        // Update level bounds.
+        auto bodyRAII = registry.get<PhysicsComponent>(tileEntity).bodyRAII;
+        const b2Vec2& bodyPosition = bodyRAII->GetBody()->GetPosition();
+        auto& levelBounds = gameState.levelOptions.levelBox2dBounds;
+        levelBounds.min = utils::Vec2Min(levelBounds.min, bodyPosition);
+        levelBounds.max = utils::Vec2Max(levelBounds.max, bodyPosition);
+
+        createdTiles++;
+    }
+}
+
 std::filesystem::path MapLoaderSystem::ReadPathToTileset(const nlohmann::json& mapJson)
 {
     std::filesystem::path tilesetPath;
@@ -252,10 +407,16 @@ void MapLoaderSystem::RecreateBox2dWorld()
 {
     auto& gameState = registry.get<GameOptions>(registry.view<GameOptions>().front());
     gameState.levelOptions.levelBox2dBounds = {};
+    gameState.levelOptions.damagedTerrainBox2dBounds = {};
+    gameState.levelOptions.terrainBitmap.reset();
 
-    // Remove all entities except the GameOptions entity.
+    // Remove all entities except the GameOptions entity. Bodies must be destroyed before the old world, so the
+    // command buffer is flushed right here.
     for (auto entity : registry.view<PhysicsComponent>())
-        registryWrapper.Destroy(entity);
+        commandBuffer.Destroy(entity);
+    for (auto entity : registry.view<RenderOnlyTileComponent>())
+        commandBuffer.Destroy(entity);
+    commandBuffer.Flush();
 
     // Create a physics world with gravity and store it in the registry.
     gameState.physicsWorld = std::make_shared<b2World>(gameState.gravity);
@@ -4,6 +4,7 @@
 #include <memory>
 #include <nlohmann/json.hpp>
 #include <utils/coordinates_transformer.h>
+#include <utils/entt/entt_command_buffer.h>
 #include <utils/entt/entt_registry_wrapper.h>
 #include <utils/factories/game_objects_factory.h>
 #include <utils/level_info.h>
@@ -15,6 +16,7 @@ class MapLoaderSystem
 {
     EnttRegistryWrapper& registryWrapper;
     entt::registry& registry;
+    EnttCommandBuffer& commandBuffer;
     ResourceManager& resourceManager;
     Box2dEnttContactListener& contactListener;
     GameOptions& gameState;
@@ -30,10 +32,11 @@ class MapLoaderSystem
     size_t invisibleTilesNumber = 0;
     std::shared_ptr<SDLTextureRAII> tilesetTexture;
     std::shared_ptr<SDLSurfaceRAII> tilesetSurface; // Optional. Used when Streaming access is needed.
+    SDL_Rect tilesetRect{}; // Rect of the tileset in the texture and the surface.
     LevelInfo currentLevelInfo;
 public:
     MapLoaderSystem(
-        EnttRegistryWrapper& registryWrapper, ResourceManager& resourceManager,
+        EnttRegistryWrapper& registryWrapper, EnttCommandBuffer& commandBuffer, ResourceManager& resourceManager,
         Box2dEnttContactListener& contactListener, GameObjectsFactory& gameObjectsFactory,
         BaseObjectsFactory& baseObjectsFactory);
     void LoadMap(const LevelInfo& levelInfo);
@@ -42,6 +45,8 @@ private:
     void ParseObjectLayer(const nlohmann::json& layer);
     void CalculateLevelBoundsWithBufferZone();
     void ParseTile(int tileId, int layerCol, int layerRow, SpawnTileOption tileOptions);
+    void StampTileToTerrainBitmap(int tileId, int layerCol, int layerRow, TerrainBitmap::Pixel pixelKind);
+    void ParseQuadTreeTile(int tileId, int layerCol, int layerRow, SpawnTileOption tileOptions);
 private: // Low level functions.
     std::filesystem::path ReadPathToTileset(const nlohmann::json& mapJson);
     void RecreateBox2dWorld();
@@ -9,9 +9,10 @@
 #include <utils/entt/entt_registry_wrapper.h>
 #include <utils/math_utils.h>
 
-PhysicsSystem::PhysicsSystem(EnttRegistryWrapper& registryWrapper)
+PhysicsSystem::PhysicsSystem(EnttRegistryWrapper& registryWrapper, EnttCommandBuffer& commandBuffer)
   : registryWrapper(registryWrapper), registry(registryWrapper.GetRegistry()),
-    gameState(registry.get<GameOptions>(registry.view<GameOptions>().front())), coordinatesTransformer(registry)
+    gameState(registry.get<GameOptions>(registry.view<GameOptions>().front())), commandBuffer(commandBuffer),
+    coordinatesTransformer(registry)
 {}
 
 void PhysicsSystem::Update(float deltaTime)
@@ -36,9 +37,10 @@ void PhysicsSystem::RemoveDistantObjects()
         auto& physicalBody = physicalBodies.get<PhysicsComponent>(entity);
         b2Vec2 posPhysics = physicalBody.bodyRAII->GetBody()->GetPosition();
 
+        // Destroyed in bulk on the next flush of the command buffer. Not in the middle of the view iteration.
         if (!utils::IsPointInsideBounds(posPhysics, levelBounds))
         {
-            registryWrapper.Destroy(entity);
+            commandBuffer.Destroy(entity);
         }
     }
 }
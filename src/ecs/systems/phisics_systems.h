@@ -2,6 +2,7 @@
 #include <entt/entt.hpp>
 #include <glm/glm.hpp>
 #include <utils/coordinates_transformer.h>
+#include <utils/entt/entt_command_buffer.h>
 #include <utils/entt/entt_registry_wrapper.h>
 #include <utils/game_options.h>
 
@@ -10,9 +11,10 @@ class PhysicsSystem
     EnttRegistryWrapper& registryWrapper;
     entt::registry& registry;
     GameOptions& gameState;
+    EnttCommandBuffer& commandBuffer;
     CoordinatesTransformer coordinatesTransformer;
 public:
-    PhysicsSystem(EnttRegistryWrapper& registryWrapper);
+    PhysicsSystem(EnttRegistryWrapper& registryWrapper, EnttCommandBuffer& commandBuffer);
     void Update(float deltaTime);
 private:
     void RemoveDistantObjects();
@@ -14,6 +14,7 @@
 #include <utils/coordinates_transformer.h>
 #include <utils/entt/entt_registry_wrapper.h>
 #include <utils/factories/box2d_body_creator.h>
+#include <utils/factories/weapon_props_factory.h>
 #include <utils/logger.h>
 #include <utils/systems/input_event_manager.h>
 
@@ -25,6 +26,9 @@ PlayerControlSystem::PlayerControlSystem(
     box2dBodyCreator(registry), contactListener(contactListener), gameObjectsFactory(gameObjectsFactory),
     audioSystem(audioSystem)
 {
+    for (const auto& [weaponType, weaponProps] : WeaponPropsFactory::CreateAllWeaponsSet())
+        shotSounds[weaponType] = audioSystem.ResolveSoundEffect(weaponProps.shotSoundName);
+
     SubscribeToInputEvents();
     SubscribeToContactListener();
 }
@@ -396,7 +400,7 @@ entt::entity PlayerControlSystem::MakeShotIfPossible(entt::entity playerEntity,
     float angle = utils::GetAngleFromDirection(playerInfo.weaponDirection);
     auto bulletEntity = gameObjectsFactory.SpawnBullet(initialPosWorld, initialBulletSpeed, angle, weaponProps);
 
-    audioSystem.PlaySoundEffect(currentWeaponProps.shotSoundName);
+    audioSystem.PlaySoundEffect(shotSounds.at(playerInfo.currentWeapon));
 
     return bulletEntity;
 }
@@ -10,6 +10,7 @@
 #include <utils/factories/box2d_body_creator.h>
 #include <utils/systems/box2d_entt_contact_listener.h>
 #include <utils/systems/input_event_manager.h>
+#include <utils/weapon.h>
 
 class PlayerControlSystem
 {
@@ -21,6 +22,7 @@ class PlayerControlSystem
     Box2dEnttContactListener& contactListener;
     GameObjectsFactory& gameObjectsFactory;
     AudioSystem& audioSystem;
+    std::unordered_map<WeaponType, SoundEffectHandle> shotSounds; // Resolved once by the names of the weapon props.
     std::unordered_map<InputEventManager::EventType, std::queue<InputEventManager::EventInfo>> eventsQueueByType;
 public:
     PlayerControlSystem(
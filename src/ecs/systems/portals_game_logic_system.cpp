@@ -16,7 +16,8 @@ PortalsGameLogicSystem::PortalsGameLogicSystem(
     entt::registry& registry, GameObjectsFactory& gameObjectsFactory, AudioSystem& audioSystem)
   : registry(registry), registryWrapper(registry), bodyTuner(registry), gameObjectsFactory(gameObjectsFactory),
     coordinatesTransformer(registry), gameState(registry.get<GameOptions>(registry.view<GameOptions>().front())),
-    audioSystem(audioSystem)
+    audioSystem(audioSystem), portalGoToPlayerSound(audioSystem.ResolveSoundEffect("portal_go_to_player")),
+    portalFeedsSound(audioSystem.ResolveSoundEffect("portal_feeds"))
 {}
 
 void PortalsGameLogicSystem::Update(float deltaTime)
@@ -103,7 +104,7 @@ void PortalsGameLogicSystem::UpdatePortalTarget(entt::entity portalEntity)
     if (newTarget && newTarget->first == PortalComponent::PortalTargetType::Player)
     {
         if ((portal.target && portal.target->first != PortalComponent::PortalTargetType::Player) || !portal.target)
-            audioSystem.PlaySoundEffect("portal_go_to_player");
+            audioSystem.PlaySoundEffect(portalGoToPlayerSound);
     }
 
     portal.target = newTarget;
@@ -177,7 +178,7 @@ void PortalsGameLogicSystem::DestroyClosestFoodInPortal()
                 registryWrapper.Destroy(entityInPortal);
             }
 
-            audioSystem.PlaySoundEffect("portal_feeds");
+            audioSystem.PlaySoundEffect(portalFeedsSound);
         });
 
     if (portalToDestroyOpt.has_value())
@@ -18,6 +18,8 @@ class PortalsGameLogicSystem
     CoordinatesTransformer coordinatesTransformer;
     GameOptions& gameState;
     AudioSystem& audioSystem;
+    SoundEffectHandle portalGoToPlayerSound;
+    SoundEffectHandle portalFeedsSound;
 public:
     PortalsGameLogicSystem(entt::registry& registry, GameObjectsFactory& gameObjectsFactory, AudioSystem& audioSystem);
     void Update(float deltaTime);
@@ -65,6 +65,27 @@ void RenderHUDSystem::RenderDebugMenu()
     ImGui::TextUnformatted(MY_FMT("{:.2f}/{:.2f} (Gr/Sc)", gravity, cameraScale).c_str());
     ImGui::TextUnformatted(MY_FMT("{}/{}/{} (Ts/Ps/DB)", tiles.size(), players.size(), dynamicBodiesCount).c_str());
     ImGui::TextUnformatted(MY_FMT("Camera center: {}", gameState.windowOptions.cameraCenterSdl).c_str());
+    const auto& debugInfo = gameState.debugInfo;
+    auto drawStats = MY_FMT("{}/{}/{}", debugInfo.drawnEntities, debugInfo.culledEntities, debugInfo.drawCalls);
+    ImGui::TextUnformatted(MY_FMT("{} (Drawn/Culled/Calls)", drawStats).c_str());
+    ImGui::TextUnformatted(MY_FMT("Resolution scale: {:.2f}", debugInfo.resolutionScale).c_str());
+
+    // Print memory of the cached resources.
+    const auto& cache = debugInfo.resourceCache;
+    auto toMegabytes = [](size_t bytes) { return static_cast<float>(bytes) / (1024.0f * 1024.0f); };
+    ImGui::TextUnformatted(MY_FMT(
+                               "Resources: {:.1f}/{:.1f} MB, evicted: {}", toMegabytes(cache.GetTotalBytes()),
+                               toMegabytes(cache.budgetBytes), cache.evictedCount)
+                               .c_str());
+    auto printUsage = [&toMegabytes](const char* name, const ResourceCacheStats::Usage& usage)
+    {
+        ImGui::TextUnformatted(MY_FMT("  {}: {} ({:.1f} MB)", name, usage.count, toMegabytes(usage.bytes)).c_str());
+    };
+    printUsage("Atlas pages (texture + CPU copy)", cache.atlasPages);
+    printUsage("Textures", cache.textures);
+    printUsage("Surfaces", cache.surfaces);
+    printUsage("Sound effects", cache.soundEffects);
+    printUsage("Musics (file size, not in total)", cache.musics);
 
     // Print debug info.
     ImGui::TextUnformatted(MY_FMT("Space pressed duration: {:.2f}", gameState.debugInfo.spacePressedDuration).c_str());
@@ -1,26 +1,72 @@
 #include "render_world_system.h"
 #include "utils/math_utils.h"
 #include <SDL_render.h>
+#include <algorithm>
 #include <ecs/components/animation_components.h>
 #include <ecs/components/physics_components.h>
 #include <ecs/components/player_components.h>
 #include <ecs/components/rendering_components.h>
+#include <ecs/components/terrain_components.h>
 #include <my_cpp_utils/config.h>
 #include <utils/box2d/box2d_glm_operators.h>
 #include <utils/debug_tools/debug_draw_bounding_box.h>
 #include <utils/logger.h>
+#include <utils/render/sprite_batcher.h>
 #include <utils/sdl/sdl_colors.h>
+#include <utils/sdl/sdl_texture_process.h>
 
 RenderWorldSystem::RenderWorldSystem(
     entt::registry& registry, SDL_Renderer* renderer, ResourceManager& resourceManager,
-    SdlPrimitivesRenderer& primitivesRenderer)
-  : registry(registry), renderer(renderer), resourceManager(resourceManager),
+    SdlPrimitivesRenderer& primitivesRenderer, DebrisParticlesPool& debrisParticlesPool)
+  : registry(registry), renderer(renderer), weaponAnimation(resourceManager.GetAnimation("scepter")),
     gameState(registry.get<GameOptions>(registry.view<GameOptions>().front())), coordinatesTransformer(registry),
-    primitivesRenderer(primitivesRenderer)
+    primitivesRenderer(primitivesRenderer), debrisParticlesPool(debrisParticlesPool),
+    staticTilesCache(registry, renderer), cameraCuller(registry), debugDraw(registry),
+    dynamicResolution(registry, renderer)
 {}
 
+void RenderWorldSystem::CaptureSnapshot()
+{
+    // Chunks are rendered to the textures of the tick. They are drawn with the sprites of the same tick.
+    staticTilesCache.Update();
+    cameraCuller.Update();
+    UploadTerrainBitmap();
+    gameState.debugInfo.drawnEntities = 0;
+
+    RenderSnapshot& snapshot = renderThread.GetSnapshotToWrite();
+    snapshot.cameraCenterSdl = gameState.windowOptions.cameraCenterSdl;
+    snapshot.cameraScale = gameState.windowOptions.cameraScale;
+    snapshot.windowSize = gameState.windowOptions.windowSize;
+    snapshot.isSpriteBatching = utils::GetConfig<bool, "SdlPrimitivesRenderer.spriteBatching">();
+    for (auto& pass : snapshot.passes)
+        pass.clear();
+    snapshot.textures.clear();
+
+    size_t visibleEntities = CaptureTiles(snapshot);
+    visibleEntities += CaptureAnimations(snapshot);
+    CapturePlayerWeaponDirection(snapshot);
+    CaptureDebrisParticles();
+    const size_t cullableEntities = GetCullableEntitiesCount();
+    gameState.debugInfo.culledEntities = cullableEntities > visibleEntities ? cullableEntities - visibleEntities : 0;
+    renderThread.Publish();
+}
+
 void RenderWorldSystem::Render()
 {
+    // Sprites were batched by the render thread with the camera of the captured tick. Other layers are drawn with the
+    // same camera, so they stay aligned with the sprites. Camera of the current tick is restored for the HUD.
+    auto& windowOptions = gameState.windowOptions;
+    const glm::vec2 cameraCenterSdl = windowOptions.cameraCenterSdl;
+    const float cameraScale = windowOptions.cameraScale;
+    if (const RenderSnapshot* drawnSnapshot = renderThread.GetPublishedSnapshot())
+    {
+        windowOptions.cameraCenterSdl = drawnSnapshot->cameraCenterSdl;
+        windowOptions.cameraScale = drawnSnapshot->cameraScale;
+    }
+
+    gameState.debugInfo.drawCalls = 0;
+    dynamicResolution.BeginFrame();
+
     // Clear the screen with white color.
     SetRenderDrawColor(renderer, ColorName::Black);
     SDL_RenderClear(renderer);
@@ -28,14 +74,32 @@ void RenderWorldSystem::Render()
     RenderBackground();
     RenderTiles();
     RenderAnimations();
-    RenderPlayerWeaponDirection();
+    RenderDebrisParticles();
 
     if (utils::GetConfig<bool, "RenderWorldSystem.debugDrawBoundingBoxes">())
         RenderBoudingBoxes();
     if (utils::GetConfig<bool, "RenderWorldSystem.debugDrawBox2dSensors">())
         RenderBox2dSensors();
 
+    if (utils::GetConfig<bool, "RenderWorldSystem.debugDrawBox2dWorld">())
+        RenderBox2dWorld();
+
     RenderDebugVisualObjects();
+    primitivesRenderer.FlushSprites();
+    debugDraw.Flush(renderer);
+    dynamicResolution.EndFrame();
+
+    windowOptions.cameraCenterSdl = cameraCenterSdl;
+    windowOptions.cameraScale = cameraScale;
+}
+
+void RenderWorldSystem::OnRenderReset(bool isDeviceReset)
+{
+    staticTilesCache.InvalidateAllChunks(isDeviceReset);
+
+    // Streaming textures keep their pixels on the targets reset. Lost chunks are uploaded again as a whole.
+    if (isDeviceReset)
+        std::fill(terrainChunkTextures.begin(), terrainChunkTextures.end(), nullptr);
 }
 
 void RenderWorldSystem::RenderBackground()
@@ -44,27 +108,275 @@ void RenderWorldSystem::RenderBackground()
     primitivesRenderer.RenderBackground(backgroundInfo);
 }
 
+size_t RenderWorldSystem::CaptureTiles(RenderSnapshot& snapshot)
+{
+    const bool isStaticTilesCacheEnabled = utils::GetConfig<bool, "RenderWorldSystem.staticTilesCache">();
+    size_t visibleEntities = 0;
+
+    // Fill the queue in one pass over the visible bodies. Only bodies inside of the camera rect are visited.
+    tilesRenderQueue.Clear();
+    for (auto entity : cameraCuller.GetVisibleBodies())
+    {
+        const auto body = registry.get<PhysicsComponent>(entity).bodyRAII->GetBody();
+
+        // Static tiles are drawn as prerendered chunks. Only moving tiles are drawn one by one.
+        auto tileComponent = registry.try_get<TileComponent>(entity);
+        if (tileComponent && !(isStaticTilesCacheEnabled && staticTilesCache.IsStaticTile(entity)))
+        {
+            const glm::vec2 posWorld = coordinatesTransformer.PhysicsToWorld(body->GetPosition());
+            tilesRenderQueue.Push(*tileComponent, posWorld, body->GetAngle());
+            visibleEntities++;
+        }
+
+        // Terrain islands. Every part is placed by its offset in the body local space.
+        if (auto compoundTiles = registry.try_get<CompoundTilesComponent>(entity))
+        {
+            for (const auto& part : compoundTiles->parts)
+            {
+                const b2Vec2 partPosPhysics =
+                    body->GetWorldPoint(coordinatesTransformer.WorldToPhysics(part.offsetWorld));
+                const glm::vec2 partPosWorld = coordinatesTransformer.PhysicsToWorld(partPosPhysics);
+                tilesRenderQueue.Push(part.tile, partPosWorld, body->GetAngle());
+            }
+            visibleEntities++;
+        }
+    }
+
+    // Decorative tiles without the Box2D bodies. They are always static, so the cache draws them if enabled.
+    if (!isStaticTilesCacheEnabled)
+    {
+        for (auto entity : cameraCuller.GetVisibleRenderOnlyTiles())
+        {
+            const auto& [tileComponent, renderOnlyTile] = registry.get<TileComponent, RenderOnlyTileComponent>(entity);
+            tilesRenderQueue.Push(tileComponent, renderOnlyTile.centerWorld, 0.0f);
+            visibleEntities++;
+        }
+    }
+
+    tilesRenderQueue.Sort();
+    gameState.debugInfo.drawnEntities += tilesRenderQueue.GetSize();
+
+    for (const auto zOrderingType : magic_enum::enum_values<ZOrderingType>())
+    {
+        const size_t pass = magic_enum::enum_index(zOrderingType).value();
+        for (const auto& item : tilesRenderQueue.GetItems(zOrderingType))
+            PushSpriteDrawItem(snapshot, pass, *item.tile, item.centerWorld, item.angle, SDL_FLIP_NONE);
+    }
+
+    return visibleEntities;
+}
+
+size_t RenderWorldSystem::CaptureAnimations(RenderSnapshot& snapshot)
+{
+    size_t visibleEntities = 0;
+    for (auto entity : cameraCuller.GetVisibleBodies())
+    {
+        auto animationComponent = registry.try_get<AnimationComponent>(entity);
+        if (!animationComponent)
+            continue;
+
+        visibleEntities++;
+
+        auto body = registry.get<PhysicsComponent>(entity).bodyRAII->GetBody();
+        glm::vec2 centerWorld = coordinatesTransformer.PhysicsToWorld(body->GetPosition());
+        if (auto frameTile = primitivesRenderer.GetAnimationFrameTile(*animationComponent, centerWorld))
+        {
+            PushSpriteDrawItem(
+                snapshot, RenderSnapshot::animationsPass, *frameTile, centerWorld, body->GetAngle(),
+                animationComponent->flip);
+            gameState.debugInfo.drawnEntities++;
+        }
+    }
+
+    return visibleEntities;
+}
+
+size_t RenderWorldSystem::GetCullableEntitiesCount() const
+{
+    size_t tilesCount = registry.view<TileComponent>().size();
+    if (utils::GetConfig<bool, "RenderWorldSystem.staticTilesCache">())
+        tilesCount -= std::min(tilesCount, staticTilesCache.GetBakedTilesCount());
+
+    return tilesCount + registry.view<CompoundTilesComponent>().size() + registry.view<AnimationComponent>().size();
+}
+
+void RenderWorldSystem::PushSpriteDrawItem(
+    RenderSnapshot& snapshot, size_t pass, const TileComponent& tile, const glm::vec2& centerWorld, float angle,
+    SDL_RendererFlip flip)
+{
+    SpriteDrawItem item{};
+    item.centerWorld = centerWorld;
+    item.sizeWorld = tile.sizeWorld;
+    item.angle = angle;
+    item.textureRect = tile.textureRect;
+    item.flip = flip;
+    item.colorName = tile.colorName;
+
+    // Tile without the texture is drawn as a colored quad.
+    if (!tile.texturePtr)
+    {
+        item.color = GetSDLColor(tile.colorName);
+        snapshot.passes[pass].push_back(item);
+        return;
+    }
+
+    int textureWidth = 0;
+    int textureHeight = 0;
+    item.texture = tile.texturePtr->get();
+    if (SDL_QueryTexture(item.texture, nullptr, nullptr, &textureWidth, &textureHeight) != 0)
+        return;
+
+    const SDL_Rect& srcRect = tile.textureRect;
+    item.color = {255, 255, 255, 255};
+    item.uvMin = {static_cast<float>(srcRect.x) / textureWidth, static_cast<float>(srcRect.y) / textureHeight};
+    item.uvMax = {
+        static_cast<float>(srcRect.x + srcRect.w) / textureWidth,
+        static_cast<float>(srcRect.y + srcRect.h) / textureHeight};
+    if (flip & SDL_FLIP_HORIZONTAL)
+        std::swap(item.uvMin.x, item.uvMax.x);
+    if (flip & SDL_FLIP_VERTICAL)
+        std::swap(item.uvMin.y, item.uvMax.y);
+
+    // Items are grouped by the texture, so the neighbour check keeps the list short.
+    if (snapshot.textures.empty() || snapshot.textures.back() != tile.texturePtr)
+        snapshot.textures.push_back(tile.texturePtr);
+    snapshot.passes[pass].push_back(item);
+}
+
+void RenderWorldSystem::RenderSprites(size_t pass)
+{
+    const RenderSnapshot* drawnSnapshot = renderThread.GetPublishedSnapshot();
+    if (!drawnSnapshot)
+        return;
+
+    // Sprites are drawn one by one if the batching is disabled.
+    if (!drawnSnapshot->isSpriteBatching)
+    {
+        for (const auto& item : drawnSnapshot->passes[pass])
+        {
+            primitivesRenderer.RenderTile(
+                item.texture, item.textureRect, item.centerWorld, item.sizeWorld, item.angle, item.colorName,
+                item.flip);
+        }
+        return;
+    }
+
+    // Sprites are drawn with the renderer directly. Tiles batched before should be drawn first.
+    primitivesRenderer.FlushSprites();
+
+    const SpriteGeometry& geometry = renderThread.WaitForGeometry();
+    for (const auto& batch : geometry.batches[pass])
+    {
+        SDL_RenderGeometry(
+            renderer, batch.texture, geometry.vertices.data(), static_cast<int>(geometry.vertices.size()),
+            geometry.indices.data() + batch.firstIndex, batch.indicesCount);
+        gameState.debugInfo.drawCalls++;
+    }
+}
+
 void RenderWorldSystem::RenderTiles()
 {
+    const bool isStaticTilesCacheEnabled = utils::GetConfig<bool, "RenderWorldSystem.staticTilesCache">();
+
     for (const auto zOrderingType : magic_enum::enum_values<ZOrderingType>())
     {
-        auto tilesView = registry.view<TileComponent, PhysicsComponent>();
-        for (auto entity : tilesView)
+        if (isStaticTilesCacheEnabled)
+        {
+            primitivesRenderer.FlushSprites();
+            staticTilesCache.Render(zOrderingType);
+        }
+
+        // Bitmap replaces the tiles of the terrain layers. Moving terrain tiles are drawn over it as before.
+        if (zOrderingType == ZOrderingType::Terrain)
+            RenderTerrainBitmap();
+
+        RenderSprites(magic_enum::enum_index(zOrderingType).value());
+    }
+}
+
+void RenderWorldSystem::UploadTerrainBitmap()
+{
+    auto terrainBitmap = gameState.levelOptions.terrainBitmap;
+    if (!terrainBitmap)
+    {
+        terrainTexturesOwner.reset();
+        terrainChunkTextures.clear();
+        return;
+    }
+
+    // Textures belong to the bitmap of the current level. Recreate them after the map reload.
+    if (terrainTexturesOwner.lock() != terrainBitmap)
+    {
+        terrainTexturesOwner = terrainBitmap;
+        terrainChunkTextures.assign(terrainBitmap->GetChunksCount(), nullptr);
+    }
+
+    const int chunkSize = terrainBitmap->GetChunkSize();
+    for (size_t chunkIndex = 0; chunkIndex < terrainBitmap->GetChunksCount(); ++chunkIndex)
+    {
+        auto& chunk = terrainBitmap->GetChunk(chunkIndex);
+        if (chunk.filledPixels == 0)
+            continue;
+
+        // Upload only the pixels changed since the last tick. The whole chunk is uploaded once on creation.
+        auto& chunkTexture = terrainChunkTextures[chunkIndex];
+        if (!chunkTexture)
+        {
+            chunkTexture = CreateStreamingTexture(renderer, chunkSize, chunkSize);
+            chunk.textureDirtyRect = {0, 0, chunkSize, chunkSize};
+        }
+
+        SDL_Rect& dirtyRect = chunk.textureDirtyRect;
+        if (dirtyRect.w > 0 && dirtyRect.h > 0)
         {
-            const auto& [tileComponent, physicalBody] = tilesView.get<TileComponent, PhysicsComponent>(entity);
-            if (tileComponent.zOrderingType != zOrderingType)
-                continue;
-
-            const glm::vec2 posWorld =
-                coordinatesTransformer.PhysicsToWorld(physicalBody.bodyRAII->GetBody()->GetPosition());
-            const float angle = physicalBody.bodyRAII->GetBody()->GetAngle();
-            primitivesRenderer.RenderTile(tileComponent, posWorld, angle);
+            const Uint32* dirtyPixels = &chunk.colors[dirtyRect.y * chunkSize + dirtyRect.x];
+            SDL_UpdateTexture(chunkTexture->get(), &dirtyRect, dirtyPixels, chunkSize * sizeof(Uint32));
+            dirtyRect = {};
         }
     }
 }
 
-void RenderWorldSystem::RenderPlayerWeaponDirection()
+void RenderWorldSystem::RenderTerrainBitmap()
 {
+    // Bitmap of the captured tick. The level may be reloaded since then.
+    auto terrainBitmap = terrainTexturesOwner.lock();
+    if (!terrainBitmap)
+        return;
+
+    // Chunks are drawn with the renderer directly. Tiles batched before should be drawn first.
+    primitivesRenderer.FlushSprites();
+
+    const int chunkSize = terrainBitmap->GetChunkSize();
+    const auto& windowSize = gameState.windowOptions.windowSize;
+    const float chunkSizeScreen = coordinatesTransformer.WorldToScreen(static_cast<float>(chunkSize));
+
+    for (size_t chunkIndex = 0; chunkIndex < terrainChunkTextures.size(); ++chunkIndex)
+    {
+        // Empty chunks and the chunks lost on the device reset have no texture.
+        const auto& chunkTexture = terrainChunkTextures[chunkIndex];
+        if (!chunkTexture || terrainBitmap->GetChunk(chunkIndex).filledPixels == 0)
+            continue;
+
+        // Skip chunks outside of the window.
+        const SDL_Rect chunkRectPixels = terrainBitmap->GetChunkRectPixels(chunkIndex);
+        const glm::vec2 chunkTopLeftWorld =
+            terrainBitmap->PixelToWorld(glm::vec2(chunkRectPixels.x, chunkRectPixels.y));
+        const glm::vec2 chunkTopLeftScreen = coordinatesTransformer.WorldToScreen(chunkTopLeftWorld);
+        if (chunkTopLeftScreen.x > windowSize.x || chunkTopLeftScreen.y > windowSize.y ||
+            chunkTopLeftScreen.x + chunkSizeScreen < 0 || chunkTopLeftScreen.y + chunkSizeScreen < 0)
+            continue;
+
+        SDL_FRect destRect{chunkTopLeftScreen.x, chunkTopLeftScreen.y, chunkSizeScreen, chunkSizeScreen};
+        SDL_RenderCopyF(renderer, chunkTexture->get(), nullptr, &destRect);
+        gameState.debugInfo.drawCalls++;
+    }
+}
+
+void RenderWorldSystem::CapturePlayerWeaponDirection(RenderSnapshot& snapshot)
+{
+    if (weaponAnimation.frames.empty())
+        return;
+
     auto players = registry.view<PhysicsComponent, PlayerComponent, AnimationComponent>();
     for (auto entity : players)
     {
@@ -77,55 +389,148 @@ void RenderWorldSystem::RenderPlayerWeaponDirection()
         const glm::vec2 playerPosWorld =
             coordinatesTransformer.PhysicsToWorld(physicalBody.bodyRAII->GetBody()->GetPosition());
         float angle = utils::GetAngleFromDirection(playerInfo.weaponDirection);
-        auto weaponAnimation = resourceManager.GetAnimation("scepter");
         SDL_RendererFlip weaponFlip =
             animationComponent.flip == SDL_FLIP_HORIZONTAL ? SDL_FLIP_VERTICAL : SDL_FLIP_NONE;
-        primitivesRenderer.RenderAnimationFirstFrame(weaponAnimation, playerPosWorld, angle, weaponFlip);
+        PushSpriteDrawItem(
+            snapshot, RenderSnapshot::animationsPass, weaponAnimation.frames.front().tileComponent, playerPosWorld,
+            angle, weaponFlip);
     }
 }
 
 void RenderWorldSystem::RenderAnimations()
 {
-    auto view = registry.view<AnimationComponent, PhysicsComponent>();
+    RenderSprites(RenderSnapshot::animationsPass);
 
-    for (auto entity : view)
+    if (!utils::GetConfig<bool, "RenderWorldSystem.debugRenderPlayerHitbox">())
+        return;
+
+    for (auto entity : cameraCuller.GetVisibleBodies())
     {
-        const auto& [animationInfo, physicsInfo] = view.get<AnimationComponent, PhysicsComponent>(entity);
+        // Bodies were culled with the snapshot. Some of them are destroyed by the tick simulated since then.
+        if (!registry.valid(entity))
+            continue;
 
-        // Caclulate the position and angle of the animation.
-        auto body = physicsInfo.bodyRAII->GetBody();
+        auto animationComponent = registry.try_get<AnimationComponent>(entity);
+        if (!animationComponent)
+            continue;
 
+        // Caclulate the position and angle of the animation.
+        auto body = registry.get<PhysicsComponent>(entity).bodyRAII->GetBody();
         glm::vec2 physicsBodyCenterWorld = coordinatesTransformer.PhysicsToWorld(body->GetPosition());
-        const float angle = body->GetAngle();
+        debugDraw.DrawRect(
+            physicsBodyCenterWorld, animationComponent->GetHitboxSize(), body->GetAngle(), ColorName::Green);
+    }
+}
 
-        primitivesRenderer.RenderAnimationComponent(animationInfo, physicsBodyCenterWorld, angle);
+void RenderWorldSystem::CaptureDebrisParticles()
+{
+    for (auto& batch : debrisBatches)
+    {
+        batch.vertices.clear();
+        batch.indices.clear();
+    }
 
-        if (utils::GetConfig<bool, "RenderWorldSystem.debugRenderPlayerHitbox">())
-        {
-            primitivesRenderer.RenderRect(
-                physicsBodyCenterWorld, animationInfo.GetHitboxSize(), angle, ColorName::Green);
-        }
+    const size_t particlesCount = debrisParticlesPool.GetCount();
+    if (particlesCount == 0)
+        return;
+
+    const auto& windowSize = gameState.windowOptions.windowSize;
+    const SDL_Color white = {255, 255, 255, 255};
+
+    // Particles are bucketed by the texture in one pass. Then one draw call per texture.
+    const auto& textures = debrisParticlesPool.GetTextures();
+    debrisBatches.resize(textures.size());
+    for (size_t textureIndex = 0; textureIndex < textures.size(); ++textureIndex)
+    {
+        auto& batch = debrisBatches[textureIndex];
+        batch.texture = textures[textureIndex];
+        int textureWidth = 0;
+        int textureHeight = 0;
+        SDL_QueryTexture(batch.texture->get(), nullptr, nullptr, &textureWidth, &textureHeight);
+        batch.textureSize = glm::vec2(textureWidth, textureHeight);
+    }
+
+    for (size_t i = 0; i < particlesCount; ++i)
+    {
+        const glm::vec2 centerScreen = coordinatesTransformer.WorldToScreen(debrisParticlesPool.GetPosition(i));
+        const float halfSizeScreen = coordinatesTransformer.WorldToScreen(debrisParticlesPool.GetSize(i)) / 2.0f;
+        if (centerScreen.x + halfSizeScreen < 0 || centerScreen.y + halfSizeScreen < 0 ||
+            centerScreen.x - halfSizeScreen > windowSize.x || centerScreen.y - halfSizeScreen > windowSize.y)
+            continue;
+
+        auto& batch = debrisBatches[debrisParticlesPool.GetTextureIndex(i)];
+        if (batch.textureSize.x <= 0 || batch.textureSize.y <= 0)
+            continue;
+
+        const SDL_Rect& srcRect = debrisParticlesPool.GetSrcRect(i);
+        const float u0 = srcRect.x / batch.textureSize.x;
+        const float v0 = srcRect.y / batch.textureSize.y;
+        const float u1 = (srcRect.x + srcRect.w) / batch.textureSize.x;
+        const float v1 = (srcRect.y + srcRect.h) / batch.textureSize.y;
+        const float left = centerScreen.x - halfSizeScreen;
+        const float top = centerScreen.y - halfSizeScreen;
+        const float right = centerScreen.x + halfSizeScreen;
+        const float bottom = centerScreen.y + halfSizeScreen;
+
+        const int firstVertex = static_cast<int>(batch.vertices.size());
+        batch.vertices.push_back({{left, top}, white, {u0, v0}});
+        batch.vertices.push_back({{right, top}, white, {u1, v0}});
+        batch.vertices.push_back({{right, bottom}, white, {u1, v1}});
+        batch.vertices.push_back({{left, bottom}, white, {u0, v1}});
+        for (int offset : {0, 1, 2, 2, 3, 0})
+            batch.indices.push_back(firstVertex + offset);
+    }
+}
+
+void RenderWorldSystem::RenderDebrisParticles()
+{
+    // Particles are drawn with the renderer directly. Tiles batched before should be drawn first.
+    primitivesRenderer.FlushSprites();
+
+    for (const auto& batch : debrisBatches)
+    {
+        if (batch.vertices.empty())
+            continue;
+
+        SDL_RenderGeometry(
+            renderer, batch.texture->get(), batch.vertices.data(), static_cast<int>(batch.vertices.size()),
+            batch.indices.data(), static_cast<int>(batch.indices.size()));
+        gameState.debugInfo.drawCalls++;
     }
 }
 
 void RenderWorldSystem::RenderBoudingBoxes()
 {
-    auto& pr = primitivesRenderer;
-    auto& ct = coordinatesTransformer;
-    DrawBoudingBoxes(pr, ct, registry.view<PhysicsComponent, PlayerComponent>(), ColorName::Green);
-    DrawBoudingBoxes(pr, ct, registry.view<PhysicsComponent, DestructibleComponent>(), ColorName::Yellow);
+    auto& dd = debugDraw;
+    auto& cc = cameraCuller;
+    DrawBoudingBoxes(dd, cc, registry.view<PhysicsComponent, PlayerComponent>(), ColorName::Green);
+    DrawBoudingBoxes(dd, cc, registry.view<PhysicsComponent, DestructibleComponent>(), ColorName::Yellow);
+    DrawBoudingBoxes(dd, cc, registry.view<PhysicsComponent, TerrainChunkComponent>(), ColorName::Yellow);
 }
 
 void RenderWorldSystem::RenderBox2dSensors()
 {
-    auto& pr = primitivesRenderer;
-    auto& ct = coordinatesTransformer;
-    DrawSensorBoxes(pr, ct, registry.view<PhysicsComponent>(), ColorName::Red);
+    auto& dd = debugDraw;
+    auto& cc = cameraCuller;
+    DrawSensorBoxes(dd, cc, registry.view<PhysicsComponent>(), ColorName::Red);
+}
+
+void RenderWorldSystem::RenderBox2dWorld()
+{
+    auto physicsWorld = gameState.physicsWorld;
+    if (!physicsWorld)
+        return;
+
+    // Shapes of all bodies, joints and the centers of mass as Box2D sees them.
+    debugDraw.SetFlags(b2Draw::e_shapeBit | b2Draw::e_jointBit | b2Draw::e_centerOfMassBit);
+    physicsWorld->SetDebugDraw(&debugDraw);
+    physicsWorld->DebugDraw();
+    physicsWorld->SetDebugDraw(nullptr);
 }
 
 void RenderWorldSystem::RenderDebugVisualObjects()
 {
-    auto& pr = primitivesRenderer;
-    auto& ct = coordinatesTransformer;
-    DrawBoudingBoxes(pr, ct, registry.view<PhysicsComponent, DebugVisualObjectComponent>(), ColorName::Yellow);
+    auto& dd = debugDraw;
+    auto& cc = cameraCuller;
+    DrawBoudingBoxes(dd, cc, registry.view<PhysicsComponent, DebugVisualObjectComponent>(), ColorName::Yellow);
 }
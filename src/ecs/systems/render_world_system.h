@@ -2,29 +2,79 @@
 #include <SDL.h>
 #include <entt/entt.hpp>
 #include <utils/coordinates_transformer.h>
+#include <utils/debug_tools/box2d_debug_draw.h>
+#include <utils/particles/debris_particles_pool.h>
+#include <utils/render/camera_culler.h>
+#include <utils/render/dynamic_resolution.h>
+#include <utils/render/render_queue.h>
+#include <utils/render/render_snapshot.h>
+#include <utils/render/render_thread.h>
+#include <utils/render/static_tiles_render_cache.h>
 #include <utils/resources/resource_manager.h>
 #include <utils/sdl/sdl_colors.h>
 #include <utils/sdl/sdl_primitives_renderer.h>
+#include <utils/terrain/terrain_bitmap.h>
+#include <vector>
 
 class RenderWorldSystem
 {
+    // Geometry of the debris particles which share one texture.
+    struct DebrisBatch
+    {
+        std::shared_ptr<SDLTextureRAII> texture; // Kept until the batch is drawn. The pool may be cleared before.
+        std::vector<SDL_Vertex> vertices;
+        std::vector<int> indices;
+        glm::vec2 textureSize;
+    };
+
     entt::registry& registry;
     SDL_Renderer* renderer;
-    ResourceManager& resourceManager;
+    const Animation& weaponAnimation; // Resolved once. Drawn for every player.
     GameOptions& gameState;
     CoordinatesTransformer coordinatesTransformer;
     SdlPrimitivesRenderer& primitivesRenderer;
+    DebrisParticlesPool& debrisParticlesPool;
+    StaticTilesRenderCache staticTilesCache;
+    CameraCuller cameraCuller;
+    Box2dDebugDraw debugDraw; // Debug lines of the frame. Drawn on top of everything in one draw call.
+    DynamicResolution dynamicResolution; // Offscreen target of the world. HUD is drawn in the full resolution.
+    TilesRenderQueue tilesRenderQueue; // Rebuilt every frame. Reused to keep the capacity.
+    RenderThread renderThread; // Builds the sprite batches of the captured snapshot while the next tick simulates.
+    std::weak_ptr<TerrainBitmap> terrainTexturesOwner; // Bitmap whose chunks are uploaded to the textures.
+    std::vector<std::shared_ptr<SDLTextureRAII>> terrainChunkTextures; // Index is the chunk index.
+    std::vector<DebrisBatch> debrisBatches; // Index is the texture index of the pool. Built with the snapshot.
 public:
     RenderWorldSystem(
         entt::registry& registry, SDL_Renderer* renderer, ResourceManager& resourceManager,
-        SdlPrimitivesRenderer& primitivesRenderer);
+        SdlPrimitivesRenderer& primitivesRenderer, DebrisParticlesPool& debrisParticlesPool);
+    // Should be called at the end of the simulation tick. Sprites are handed off to the render thread.
+    void CaptureSnapshot();
+    // Draw the world of the last captured tick with the camera of that tick. Should be called before the next capture.
     void Render();
+    // Prerendered textures are rebuilt after SDL_RENDER_TARGETS_RESET or SDL_RENDER_DEVICE_RESET.
+    void OnRenderReset(bool isDeviceReset);
+private: //////////////////////////// Capture snapshot methods. //////////////////////////
+    // Return the number of the drawable entities which passed the culling.
+    size_t CaptureTiles(RenderSnapshot& snapshot);
+    size_t CaptureAnimations(RenderSnapshot& snapshot);
+    void CapturePlayerWeaponDirection(RenderSnapshot& snapshot);
+    void CaptureDebrisParticles();
+    // Pixels changed by the tick are uploaded with the snapshot, so the bitmap is drawn in the same state as sprites.
+    void UploadTerrainBitmap();
+    // Drawable entities which are culled one by one. Tiles drawn by the static cache are culled by chunks.
+    [[nodiscard]] size_t GetCullableEntitiesCount() const;
+    void PushSpriteDrawItem(
+        RenderSnapshot& snapshot, size_t pass, const TileComponent& tile, const glm::vec2& centerWorld, float angle,
+        SDL_RendererFlip flip);
 private: //////////////////////////// Render game objects methods. //////////////////////////
+    void RenderSprites(size_t pass);
     void RenderBackground();
     void RenderTiles();
+    void RenderTerrainBitmap();
     void RenderAnimations();
-    void RenderPlayerWeaponDirection();
+    void RenderDebrisParticles();
     void RenderBoudingBoxes();
     void RenderBox2dSensors();
+    void RenderBox2dWorld();
     void RenderDebugVisualObjects();
 };
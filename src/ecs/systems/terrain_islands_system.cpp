@@ -0,0 +1,305 @@
+#include "terrain_islands_system.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <ecs/components/physics_components.h>
+#include <ecs/components/rendering_components.h>
+#include <my_cpp_utils/config.h>
+#include <unordered_map>
+#include <utils/logger.h>
+
+namespace
+{
+
+// Tiles of the terrain touch each other by the edges. Corner contact does not connect tiles.
+bool AreTilesConnected(const glm::vec2& minA, const glm::vec2& maxA, const glm::vec2& minB, const glm::vec2& maxB)
+{
+    constexpr float epsilon = 0.5f; // In world pixels. Tiles are aligned to the pixel grid.
+    float overlapX = std::min(maxA.x, maxB.x) - std::max(minA.x, minB.x);
+    float overlapY = std::min(maxA.y, maxB.y) - std::max(minA.y, minB.y);
+    return overlapX > -epsilon && overlapY > -epsilon && (overlapX > epsilon || overlapY > epsilon);
+}
+
+// Indestructible terrain stored in the TerrainBitmap has no tile entities. Tiles touching it are anchored.
+// Pixels of the one pixel wide ring around the tile are checked. Corners are skipped like in AreTilesConnected.
+bool IsTouchingIndestructiblePixels(const TerrainBitmap& bitmap, const glm::vec2& minWorld, const glm::vec2& maxWorld)
+{
+    const glm::ivec2 ringMin = bitmap.WorldToPixel(minWorld) - glm::ivec2(1, 1);
+    const glm::ivec2 ringMax = bitmap.WorldToPixel(maxWorld);
+    auto isIndestructible = [&bitmap](int x, int y)
+    { return bitmap.GetPixel(x, y) == TerrainBitmap::Pixel::Indestructible; };
+
+    for (int x = ringMin.x + 1; x < ringMax.x; ++x)
+    {
+        if (isIndestructible(x, ringMin.y) || isIndestructible(x, ringMax.y))
+            return true;
+    }
+    for (int y = ringMin.y + 1; y < ringMax.y; ++y)
+    {
+        if (isIndestructible(ringMin.x, y) || isIndestructible(ringMax.x, y))
+            return true;
+    }
+    return false;
+}
+
+uint64_t PackCell(int x, int y)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+// Call `callback` with the packed key of every spatial hash cell covered by the rect.
+template <typename Callback>
+void ForEachCell(float cellSize, const glm::vec2& minWorld, const glm::vec2& maxWorld, Callback&& callback)
+{
+    auto toCell = [cellSize](float valueWorld) { return static_cast<int>(std::floor(valueWorld / cellSize)); };
+    for (int y = toCell(minWorld.y); y <= toCell(maxWorld.y); ++y)
+        for (int x = toCell(minWorld.x); x <= toCell(maxWorld.x); ++x)
+            callback(PackCell(x, y));
+}
+
+} // namespace
+
+TerrainIslandsSystem::TerrainIslandsSystem(
+    entt::registry& registry, EnttCommandBuffer& commandBuffer, BaseObjectsFactory& baseObjectsFactory)
+  : registry(registry), gameState(registry.get<GameOptions>(registry.view<GameOptions>().front())),
+    commandBuffer(commandBuffer), baseObjectsFactory(baseObjectsFactory), coordinatesTransformer(registry)
+{
+    registry.on_construct<PhysicsComponent>().connect<&TerrainIslandsSystem::OnPhysicsComponentConstructed>(this);
+    registry.on_destroy<PhysicsComponent>().connect<&TerrainIslandsSystem::OnTileLeftTerrain>(this);
+    // Tiles thrown by the explosions become dynamic Box2D debris. They are not a part of the terrain anymore.
+    registry.on_construct<ExplostionParticlesComponent>().connect<&TerrainIslandsSystem::OnTileLeftTerrain>(this);
+}
+
+TerrainIslandsSystem::~TerrainIslandsSystem()
+{
+    registry.on_construct<PhysicsComponent>().disconnect(this);
+    registry.on_destroy<PhysicsComponent>().disconnect(this);
+    registry.on_construct<ExplostionParticlesComponent>().disconnect(this);
+}
+
+void TerrainIslandsSystem::Update()
+{
+    // The index belongs to the level. Rebuild it after the map reload.
+    if (indexOwner.lock() != gameState.physicsWorld)
+    {
+        indexOwner = gameState.physicsWorld;
+        RebuildIndex();
+    }
+
+    for (auto entity : constructedBodies)
+        IndexStaticTile(entity);
+    constructedBodies.clear();
+
+    auto& damagedBounds = gameState.levelOptions.damagedTerrainBox2dBounds;
+    if (damagedBounds.min.x > damagedBounds.max.x || damagedBounds.min.y > damagedBounds.max.y)
+        return;
+
+    glm::vec2 damagedMinWorld = coordinatesTransformer.PhysicsToWorld(damagedBounds.min);
+    glm::vec2 damagedMaxWorld = coordinatesTransformer.PhysicsToWorld(damagedBounds.max);
+    damagedBounds = {};
+
+    if (!utils::GetConfig<bool, "TerrainIslandsSystem.enabled">())
+        return;
+
+    auto islands = FindIslands(damagedMinWorld, damagedMaxWorld);
+
+    for (const auto& islandEntities : islands)
+    {
+        baseObjectsFactory.SpawnTerrainIsland(islandEntities);
+
+        // Originals are destroyed on the next flush, before the physics step.
+        for (auto entity : islandEntities)
+            commandBuffer.Destroy(entity);
+    }
+
+    if (!islands.empty())
+    {
+        MY_LOG(
+            debug, "[TerrainIslandsSystem] Found {} islands among {} terrain tiles", islands.size(),
+            indexedTiles.size());
+    }
+}
+
+void TerrainIslandsSystem::RebuildIndex()
+{
+    indexedTiles.clear();
+    tilesByCell.clear();
+    constructedBodies.clear();
+    cellSize = utils::GetConfig<float, "TerrainIslandsSystem.spatialHashCellSize">();
+
+    for (auto entity : registry.view<TileComponent, PhysicsComponent, CollidableComponent>())
+        IndexStaticTile(entity);
+
+    MY_LOG(debug, "[TerrainIslandsSystem] Spatial hash rebuilt. Static tiles count {}", indexedTiles.size());
+}
+
+void TerrainIslandsSystem::IndexStaticTile(entt::entity entity)
+{
+    if (!registry.valid(entity) || indexedTiles.contains(entity))
+        return;
+
+    if (!registry.all_of<TileComponent, PhysicsComponent, CollidableComponent>(entity) ||
+        registry.any_of<ExplostionParticlesComponent>(entity))
+        return;
+
+    // Terrain tiles are static and not rotated. Dynamic bodies are not a part of the terrain.
+    auto body = registry.get<PhysicsComponent>(entity).bodyRAII->GetBody();
+    if (body->GetType() != b2_staticBody)
+        return;
+
+    const glm::vec2 centerWorld = coordinatesTransformer.PhysicsToWorld(body->GetPosition());
+    const glm::vec2 halfSizeWorld = registry.get<TileComponent>(entity).sizeWorld / 2.0f;
+    const glm::vec2 minWorld = centerWorld - halfSizeWorld;
+    const glm::vec2 maxWorld = centerWorld + halfSizeWorld;
+    // Anchoring rule. Tile is an anchor if it is indestructible itself, or if it touches an indestructible pixel of
+    // the TerrainBitmap by an edge (IsTouchingIndestructiblePixels). Indestructible terrain stored as chain shapes
+    // has no tile entities, so the second check replaces them. Everything connected to an anchor by edges stays.
+    // Explosions never carve the indestructible pixels, so the flag is computed once.
+    auto terrainBitmap = gameState.levelOptions.terrainBitmap;
+    bool isAnchor = registry.all_of<IndestructibleComponent>(entity) ||
+        (terrainBitmap && IsTouchingIndestructiblePixels(*terrainBitmap, minWorld, maxWorld));
+
+    indexedTiles.emplace(entity, TerrainTile{minWorld, maxWorld, isAnchor});
+    ForEachCell(cellSize, minWorld, maxWorld, [&](uint64_t cell) { tilesByCell[cell].push_back(entity); });
+}
+
+void TerrainIslandsSystem::OnPhysicsComponentConstructed(
+    [[maybe_unused]] entt::registry& changedRegistry, entt::entity entity)
+{
+    // Other components of the tile are emplaced after the body. So the tile is checked on the next update.
+    constructedBodies.push_back(entity);
+}
+
+void TerrainIslandsSystem::OnTileLeftTerrain([[maybe_unused]] entt::registry& changedRegistry, entt::entity entity)
+{
+    auto it = indexedTiles.find(entity);
+    if (it == indexedTiles.end())
+        return;
+
+    ForEachCell(
+        cellSize, it->second.minWorld, it->second.maxWorld,
+        [&](uint64_t cell)
+        {
+            auto cellIt = tilesByCell.find(cell);
+            if (cellIt == tilesByCell.end())
+                return;
+
+            auto& cellTiles = cellIt->second;
+            auto tileIt = std::find(cellTiles.begin(), cellTiles.end(), entity);
+            if (tileIt != cellTiles.end())
+            {
+                *tileIt = cellTiles.back();
+                cellTiles.pop_back();
+            }
+            if (cellTiles.empty())
+                tilesByCell.erase(cellIt);
+        });
+    indexedTiles.erase(it);
+}
+
+std::vector<std::vector<entt::entity>> TerrainIslandsSystem::FindIslands(
+    const glm::vec2& damagedMinWorld, const glm::vec2& damagedMaxWorld)
+{
+    auto& maxIslandTiles = utils::GetConfig<size_t, "TerrainIslandsSystem.maxIslandTiles">();
+    auto& searchMargin = utils::GetConfig<float, "TerrainIslandsSystem.searchMargin">();
+
+    enum class State : uint8_t
+    {
+        InProgress,
+        Anchored,
+        Island,
+    };
+    // Only the visited tiles get a state. Missing state means the tile is not visited yet.
+    std::unordered_map<entt::entity, State> states;
+
+    // Only tiles near the craters may lose the connection. Seeds are taken from the cells around the damaged area.
+    const glm::vec2 searchMinWorld = damagedMinWorld - glm::vec2(searchMargin, searchMargin);
+    const glm::vec2 searchMaxWorld = damagedMaxWorld + glm::vec2(searchMargin, searchMargin);
+    std::vector<entt::entity> seeds;
+    ForEachCell(
+        cellSize, searchMinWorld, searchMaxWorld,
+        [&](uint64_t cell)
+        {
+            auto cellIt = tilesByCell.find(cell);
+            if (cellIt == tilesByCell.end())
+                return;
+
+            for (auto entity : cellIt->second)
+            {
+                const auto& tile = indexedTiles.at(entity);
+                if (tile.isAnchor || tile.maxWorld.x < searchMinWorld.x || tile.maxWorld.y < searchMinWorld.y ||
+                    tile.minWorld.x > searchMaxWorld.x || tile.minWorld.y > searchMaxWorld.y)
+                    continue;
+
+                seeds.push_back(entity);
+            }
+        });
+
+    std::vector<std::vector<entt::entity>> islands;
+    std::vector<entt::entity> component;
+    std::vector<entt::entity> stack;
+    for (auto seed : seeds)
+    {
+        // Tiles covering several cells are seen several times.
+        if (states.contains(seed))
+            continue;
+
+        // Flood fill. Stops as soon as an anchor is reached. Too big components are treated as anchored.
+        component.clear();
+        stack.assign(1, seed);
+        states[seed] = State::InProgress;
+        bool isAnchored = false;
+        while (!stack.empty() && !isAnchored)
+        {
+            auto entity = stack.back();
+            stack.pop_back();
+            component.push_back(entity);
+            const auto& tile = indexedTiles.at(entity);
+
+            if (tile.isAnchor || component.size() > maxIslandTiles)
+            {
+                isAnchored = true;
+                break;
+            }
+
+            ForEachCell(
+                cellSize, tile.minWorld, tile.maxWorld,
+                [&](uint64_t cell)
+                {
+                    auto cellIt = tilesByCell.find(cell);
+                    if (isAnchored || cellIt == tilesByCell.end())
+                        return;
+
+                    for (auto neighbourEntity : cellIt->second)
+                    {
+                        auto stateIt = states.find(neighbourEntity);
+                        if (stateIt != states.end() && stateIt->second == State::InProgress)
+                            continue;
+
+                        const auto& neighbour = indexedTiles.at(neighbourEntity);
+                        if (!AreTilesConnected(tile.minWorld, tile.maxWorld, neighbour.minWorld, neighbour.maxWorld))
+                            continue;
+
+                        if (stateIt != states.end() && stateIt->second == State::Anchored)
+                        {
+                            isAnchored = true;
+                            return;
+                        }
+
+                        states[neighbourEntity] = State::InProgress;
+                        stack.push_back(neighbourEntity);
+                    }
+                });
+        }
+
+        // Tiles left in the stack are connected to the component. They share its state.
+        component.insert(component.end(), stack.begin(), stack.end());
+        for (auto entity : component)
+            states[entity] = isAnchored ? State::Anchored : State::Island;
+
+        if (!isAnchored)
+            islands.push_back(component);
+    }
+
+    return islands;
+}
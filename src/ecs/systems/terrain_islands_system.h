@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+#include <memory>
+#include <unordered_map>
+#include <utils/coordinates_transformer.h>
+#include <utils/entt/entt_command_buffer.h>
+#include <utils/factories/base_objects_factory.h>
+#include <utils/game_options.h>
+#include <vector>
+
+// Finds terrain tiles which lost the connection with the anchors after explosions. Each disconnected island is
+// replaced with one compound dynamic body. Anchors are indestructible collidable tiles and tiles touching the
+// indestructible pixels of the TerrainBitmap. Islands stay destructible: explosions remove their parts.
+// The spatial hash of the static tiles follows the tiles through the EnTT signals.
+class TerrainIslandsSystem
+{
+    struct TerrainTile
+    {
+        glm::vec2 minWorld;
+        glm::vec2 maxWorld;
+        bool isAnchor;
+    };
+
+    entt::registry& registry;
+    GameOptions& gameState;
+    EnttCommandBuffer& commandBuffer;
+    BaseObjectsFactory& baseObjectsFactory;
+    CoordinatesTransformer coordinatesTransformer;
+    std::weak_ptr<b2World> indexOwner; // Physics world whose static tiles are indexed.
+    float cellSize = 0.0f; // Cell size of the spatial hash. Read from the config on the rebuild.
+    std::unordered_map<entt::entity, TerrainTile> indexedTiles;
+    std::unordered_map<uint64_t, std::vector<entt::entity>> tilesByCell; // Tile is registered in every cell it covers.
+    std::vector<entt::entity> constructedBodies; // Indexed on the next update if they are static tiles.
+public:
+    TerrainIslandsSystem(
+        entt::registry& registry, EnttCommandBuffer& commandBuffer, BaseObjectsFactory& baseObjectsFactory);
+    ~TerrainIslandsSystem();
+    TerrainIslandsSystem(const TerrainIslandsSystem&) = delete;
+    TerrainIslandsSystem& operator=(const TerrainIslandsSystem&) = delete;
+    // Should be called after the destructions of the explosions are flushed.
+    void Update();
+private:
+    void RebuildIndex();
+    void IndexStaticTile(entt::entity entity);
+    void OnPhysicsComponentConstructed(entt::registry& changedRegistry, entt::entity entity);
+    // Body is destroyed or thrown by an explosion. Its tile is removed from the spatial hash.
+    void OnTileLeftTerrain(entt::registry& changedRegistry, entt::entity entity);
+    // Return islands as lists of tile entities. Only tiles near the damaged area are used as flood fill seeds.
+    std::vector<std::vector<entt::entity>> FindIslands(
+        const glm::vec2& damagedMinWorld, const glm::vec2& damagedMaxWorld);
+};
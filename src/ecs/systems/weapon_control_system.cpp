@@ -1,20 +1,23 @@
 #include "weapon_control_system.h"
 #include "utils/factories/base_objects_factory.h"
 #include <SDL_rect.h>
+#include <algorithm>
 #include <box2d/b2_body.h>
 #include <box2d/b2_math.h>
 #include <ecs/components/event_components.h>
 #include <ecs/components/physics_components.h>
+#include <ecs/components/portal_components.h>
 #include <ecs/components/rendering_components.h>
+#include <ecs/components/terrain_components.h>
 #include <ecs/components/weapon_components.h>
 #include <entt/entity/fwd.hpp>
 #include <my_cpp_utils/config.h>
 #include <my_cpp_utils/logger.h>
 #include <my_cpp_utils/math_utils.h>
+#include <numeric>
 #include <utils/box2d/box2d_body_tuner.h>
 #include <utils/box2d/box2d_glm_operators.h>
 #include <utils/coordinates_transformer.h>
-#include <utils/entt/entt_registry_requests.h>
 #include <utils/entt/entt_registry_wrapper.h>
 #include <utils/factories/box2d_body_creator.h>
 #include <utils/factories/game_objects_factory.h>
@@ -24,12 +27,13 @@
 #include <utils/systems/box2d_entt_contact_listener.h>
 
 WeaponControlSystem::WeaponControlSystem(
-    EnttRegistryWrapper& registryWrapper, Box2dEnttContactListener& contactListener, AudioSystem& audioSystem,
-    BaseObjectsFactory& baseObjectsFactory)
+    EnttRegistryWrapper& registryWrapper, EnttCommandBuffer& commandBuffer, Box2dEnttContactListener& contactListener,
+    AudioSystem& audioSystem, BaseObjectsFactory& baseObjectsFactory, DebrisParticlesPool& debrisParticlesPool)
   : registryWrapper(registryWrapper), registry(registryWrapper.GetRegistry()),
-    gameState(registry.get<GameOptions>(registry.view<GameOptions>().front())), contactListener(contactListener),
-    audioSystem(audioSystem), baseObjectsFactory(baseObjectsFactory), coordinatesTransformer(registry),
-    physicsBodyTuner(registry)
+    gameState(registry.get<GameOptions>(registry.view<GameOptions>().front())), commandBuffer(commandBuffer),
+    contactListener(contactListener), audioSystem(audioSystem),
+    explosionSound(audioSystem.ResolveSoundEffect("explosion")), baseObjectsFactory(baseObjectsFactory),
+    debrisParticlesPool(debrisParticlesPool), coordinatesTransformer(registry), physicsBodyTuner(registry)
 {
     SubscribeToContactEvents();
 }
@@ -68,7 +72,9 @@ void WeaponControlSystem::SubscribeToContactEvents()
                     {
                         // If it is in flight, then the explosion should not be triggered.
                         // Body should become static and explosion should be triggered on the next contact.
-                        becomeStaticEntitiesQueue.insert(explosionEntity);
+                        // Box2D world is locked here, so the body option is changed on the command buffer flush.
+                        commandBuffer.ApplyOption(explosionEntity, Box2dBodyOptions::MovementPolicy::Manual);
+                        stickedThisStepEntities.insert(explosionEntity);
                         stickFlagComponent.isSticked = true;
                         shouldExplode = false;
                     }
@@ -127,11 +133,13 @@ void WeaponControlSystem::CheckTimerExplosionEntities()
         if (!timerComponent.isActivated)
             continue;
 
-        DoExplosion({timerExplosionEntity, std::nullopt});
+        // Timer explosions are processed in the same batch with contact explosions.
+        AppendToExplosionQueue({timerExplosionEntity, std::nullopt});
     }
 }
 
-void WeaponControlSystem::DoExplosion(const ExplosionEntityWithContactPoint& explosionEntityWithContactPoint)
+std::optional<WeaponControlSystem::Blast> WeaponControlSystem::CalculateBlast(
+    const ExplosionEntityWithContactPoint& explosionEntityWithContactPoint)
 {
     auto& explosionEntity = explosionEntityWithContactPoint.explosionEntity;
 
@@ -139,7 +147,7 @@ void WeaponControlSystem::DoExplosion(const ExplosionEntityWithContactPoint& exp
     auto physicsInfo = registry.try_get<PhysicsComponent>(explosionEntity);
 
     if (!damageComponent || !physicsInfo)
-        return;
+        return std::nullopt;
 
     // Calculate the contact point in the physics world.
     b2Vec2 contactPointPhysics =
@@ -156,65 +164,283 @@ void WeaponControlSystem::DoExplosion(const ExplosionEntityWithContactPoint& exp
             contactPointWorld, {2.f, 2.f}, 0.0f, MY_FMT("ExplosionContactPoint {}", explosionEntity), options);
     }
 
-    // TODO1: It is possuble to rewrite next code to use entt::view.
-
-    // Get all physical bodies in the explosion radius.
-    float damageRadius =
+    Blast blast;
+    blast.explosionEntity = explosionEntity;
+    blast.centerPhysics = contactPointPhysics;
+    blast.damageRadiusPhysics =
         damageComponent->radius * 1.5; // TODO0: hack. Need to calculate it based on the texture size.
                                        // Because position is calculated from the center of the texture.
-    std::vector<entt::entity> allOriginalBodiesInRadius =
-        request::FindEntitiesWithAllComponentsInRadius(registry, contactPointPhysics, damageRadius);
-    MY_LOG(debug, "[DoExplosion] FindEntitiesInRadius count {}", allOriginalBodiesInRadius.size());
+    blast.craterRadiusPhysics = damageComponent->radius;
+    blast.force = damageComponent->force;
+    return blast;
+}
 
-    // Get destructible objects.
-    auto destructibleOriginalBodies =
-        request::GetEntitiesWithAllComponents<DestructibleComponent>(registry, allOriginalBodiesInRadius);
-    destructibleOriginalBodies =
-        request::RemoveEntitiesWithAllComponents<ExplostionParticlesComponent>(registry, destructibleOriginalBodies);
-    MY_LOG(debug, "[DoExplosion] Getting destructible objects. Count {}", destructibleOriginalBodies.size());
+std::vector<WeaponControlSystem::BlastRegion> WeaponControlSystem::MergeOverlappingBlasts(
+    const std::vector<Blast>& blasts)
+{
+    // Union-find over the blasts. Blasts are merged if their damage circles overlap.
+    std::vector<size_t> parents(blasts.size());
+    std::iota(parents.begin(), parents.end(), 0);
+    auto findRoot = [&parents](size_t index)
+    {
+        while (parents[index] != index)
+        {
+            parents[index] = parents[parents[index]];
+            index = parents[index];
+        }
+        return index;
+    };
+
+    for (size_t i = 0; i < blasts.size(); ++i)
+    {
+        for (size_t j = i + 1; j < blasts.size(); ++j)
+        {
+            float distance = b2Distance(blasts[i].centerPhysics, blasts[j].centerPhysics);
+            if (distance < blasts[i].damageRadiusPhysics + blasts[j].damageRadiusPhysics)
+                parents[findRoot(i)] = findRoot(j);
+        }
+    }
+
+    std::map<size_t, std::vector<size_t>> blastIndicesByRoot;
+    for (size_t i = 0; i < blasts.size(); ++i)
+        blastIndicesByRoot[findRoot(i)].push_back(i);
+
+    // Region is a circle around the bounding box of all blasts of the group.
+    std::vector<BlastRegion> regions;
+    for (auto& [root, blastIndices] : blastIndicesByRoot)
+    {
+        b2Vec2 lowerBound = blasts[root].centerPhysics;
+        b2Vec2 upperBound = blasts[root].centerPhysics;
+        for (size_t blastIndex : blastIndices)
+        {
+            const auto& blast = blasts[blastIndex];
+            b2Vec2 radius(blast.damageRadiusPhysics, blast.damageRadiusPhysics);
+            lowerBound = b2Min(lowerBound, blast.centerPhysics - radius);
+            upperBound = b2Max(upperBound, blast.centerPhysics + radius);
+        }
+
+        BlastRegion region;
+        region.centerPhysics = 0.5f * (lowerBound + upperBound);
+        region.radiusPhysics = 0.0f;
+        for (size_t blastIndex : blastIndices)
+        {
+            const auto& blast = blasts[blastIndex];
+            float distance = b2Distance(region.centerPhysics, blast.centerPhysics) + blast.damageRadiusPhysics;
+            region.radiusPhysics = std::max(region.radiusPhysics, distance);
+        }
+        region.blastIndices = std::move(blastIndices);
+        regions.push_back(std::move(region));
+    }
+
+    return regions;
+}
+
+void WeaponControlSystem::DoExplosions(const std::vector<Blast>& blasts)
+{
+    if (blasts.empty())
+        return;
+
+    auto regions = MergeOverlappingBlasts(blasts);
+    MY_LOG(debug, "[DoExplosions] Blasts count {}, merged regions count {}", blasts.size(), regions.size());
+
+    // `extensionPhysics` grows the blasts. Used for big bodies which should be hit before the blast reaches the center.
+    auto isInsideAnyBlast = [&](const b2Vec2& posPhysics, float extensionPhysics = 0.0f)
+    {
+        for (const auto& region : regions)
+        {
+            if (b2Distance(posPhysics, region.centerPhysics) >= region.radiusPhysics + extensionPhysics)
+                continue;
+
+            for (size_t blastIndex : region.blastIndices)
+            {
+                const auto& blast = blasts[blastIndex];
+                if (b2Distance(posPhysics, blast.centerPhysics) < blast.damageRadiusPhysics + extensionPhysics)
+                    return true;
+            }
+        }
+        return false;
+    };
+
+    // Same for the axis aligned rect given by its center and half size.
+    auto isRectTouchingAnyBlast = [&](const b2Vec2& centerPhysics, const b2Vec2& halfSizePhysics)
+    {
+        const b2Vec2 minPhysics = centerPhysics - halfSizePhysics;
+        const b2Vec2 maxPhysics = centerPhysics + halfSizePhysics;
+        auto isTouchingCircle = [&](const b2Vec2& circleCenterPhysics, float radiusPhysics)
+        {
+            b2Vec2 closestPointPhysics = b2Clamp(circleCenterPhysics, minPhysics, maxPhysics);
+            return b2Distance(closestPointPhysics, circleCenterPhysics) < radiusPhysics;
+        };
+
+        for (const auto& region : regions)
+        {
+            if (!isTouchingCircle(region.centerPhysics, region.radiusPhysics))
+                continue;
+
+            for (size_t blastIndex : region.blastIndices)
+            {
+                const auto& blast = blasts[blastIndex];
+                if (isTouchingCircle(blast.centerPhysics, blast.damageRadiusPhysics))
+                    return true;
+            }
+        }
+        return false;
+    };
+
+    // Get destructible bodies in the blasts with one pass over the registry.
+    // Body covered by several blasts is taken once, so every tile is splitted once per frame.
+    std::vector<entt::entity> destructibleOriginalBodies;
+    std::vector<entt::entity> damagedIslands;
+    auto destructibleView =
+        registry.view<PhysicsComponent, DestructibleComponent>(entt::exclude<ExplostionParticlesComponent>);
+    for (auto entity : destructibleView)
+    {
+        const auto& physicsComponent = destructibleView.get<PhysicsComponent>(entity);
+        const b2Vec2& posPhysics = physicsComponent.bodyRAII->GetBody()->GetPosition();
+
+        // Lazily subdivided tiles may be much bigger than the blast. They are hit when the blast overlaps their rect.
+        // Static terrain is not rotated, so the rect is axis aligned.
+        auto tileComponent = registry.try_get<TileComponent>(entity);
+        if (tileComponent && registry.all_of<QuadTreeTileComponent>(entity))
+        {
+            b2Vec2 halfSizePhysics(
+                coordinatesTransformer.WorldToPhysics(tileComponent->sizeWorld.x / 2.0f),
+                coordinatesTransformer.WorldToPhysics(tileComponent->sizeWorld.y / 2.0f));
+            if (isRectTouchingAnyBlast(posPhysics, halfSizePhysics))
+                destructibleOriginalBodies.push_back(entity);
+            continue;
+        }
+
+        // Islands are hit when the blast overlaps the circle around their parts. Parts are checked one by one below.
+        float extensionPhysics = 0.0f;
+        auto compoundTiles = registry.try_get<CompoundTilesComponent>(entity);
+        if (compoundTiles)
+        {
+            float radiusWorld = 0.0f;
+            for (const auto& part : compoundTiles->parts)
+            {
+                radiusWorld = std::max(
+                    radiusWorld, glm::length(part.offsetWorld) + glm::length(part.tile.sizeWorld) / 2.0f);
+            }
+            extensionPhysics = coordinatesTransformer.WorldToPhysics(radiusWorld);
+        }
+
+        if (!isInsideAnyBlast(posPhysics, extensionPhysics))
+            continue;
+
+        if (compoundTiles)
+            damagedIslands.push_back(entity);
+        else
+            destructibleOriginalBodies.push_back(entity);
+    }
+    MY_LOG(debug, "[DoExplosions] Getting destructible objects. Count {}", destructibleOriginalBodies.size());
 
     // Split original objects to micro objects.
     auto& cellSizeForMicroDistruction = utils::GetConfig<int, "WeaponControlSystem.cellSizeForMicroDistruction">();
     SDL_Point cellSize = {cellSizeForMicroDistruction, cellSizeForMicroDistruction};
-    auto newMicroBodies = baseObjectsFactory.SpawnSplittedPhysicalEnteties(destructibleOriginalBodies, cellSize);
-    MY_LOG(debug, "[DoExplosion] Spawn micro splittedEntities count {}", newMicroBodies.size());
+    std::vector<entt::entity> newMicroBodies;
+    if (utils::GetConfig<bool, "WeaponControlSystem.craterRingOnlySplitting">())
+    {
+        // Cells inside the blasts are not created at all. So there is nothing to destroy below.
+        // Tiles which lose no cell are dropped from `destructibleOriginalBodies` and stay untouched.
+        std::vector<BaseObjectsFactory::CraterWorld> cratersWorld;
+        for (const auto& blast : blasts)
+        {
+            cratersWorld.push_back(
+                {coordinatesTransformer.PhysicsToWorld(blast.centerPhysics),
+                 coordinatesTransformer.PhysicsToWorld(blast.damageRadiusPhysics)});
+        }
+        newMicroBodies =
+            baseObjectsFactory.SpawnCraterRingPhysicalEnteties(destructibleOriginalBodies, cellSize, cratersWorld);
+    }
+    else
+    {
+        newMicroBodies = baseObjectsFactory.SpawnSplittedPhysicalEnteties(destructibleOriginalBodies, cellSize);
+    }
+    MY_LOG(debug, "[DoExplosions] Spawn micro splittedEntities count {}", newMicroBodies.size());
 
-    // Get micro objects in the explosion radius.
-    auto newMicroBodiesToDestroy =
-        request::FilterEntitiesWithAllComponentsInRadius(registry, newMicroBodies, contactPointPhysics, damageRadius);
+    // Destroy micro objects in any of the blasts.
+    size_t destroyedMicroBodiesCount = 0;
+    for (auto& entity : newMicroBodies)
+    {
+        const auto& physicsComponent = registry.get<PhysicsComponent>(entity);
+        if (!isInsideAnyBlast(physicsComponent.bodyRAII->GetBody()->GetPosition()))
+            continue;
 
-    // Destroy micro objects in the explosion radius.
-    MY_LOG(debug, "[DoExplosion] Destroing {} micro objects", newMicroBodiesToDestroy.size());
-    for (auto& entity : newMicroBodiesToDestroy)
-        registryWrapper.Destroy(entity);
+        commandBuffer.Destroy(entity);
+        destroyedMicroBodiesCount++;
+    }
+    MY_LOG(debug, "[DoExplosions] Destroing {} micro objects", destroyedMicroBodiesCount);
+
+    // Island parts are not split. Parts which centers are inside the blasts are removed, remains keep falling as one
+    // body. Island which lost no part is kept as is.
+    for (auto islandEntity : damagedIslands)
+    {
+        auto islandBody = registry.get<PhysicsComponent>(islandEntity).bodyRAII->GetBody();
+        const auto& parts = registry.get<CompoundTilesComponent>(islandEntity).parts;
+        std::vector<bool> destroyedParts(parts.size(), false);
+        bool isAnyPartDestroyed = false;
+        for (size_t partIndex = 0; partIndex < parts.size(); ++partIndex)
+        {
+            b2Vec2 offsetPhysics = coordinatesTransformer.WorldToPhysics(
+                parts[partIndex].offsetWorld, CoordinatesTransformer::Type::Length);
+            destroyedParts[partIndex] = isInsideAnyBlast(islandBody->GetWorldPoint(offsetPhysics));
+            isAnyPartDestroyed = isAnyPartDestroyed || destroyedParts[partIndex];
+        }
+
+        if (!isAnyPartDestroyed)
+            continue;
+
+        baseObjectsFactory.SpawnDamagedTerrainIsland(islandEntity, destroyedParts);
+        commandBuffer.Destroy(islandEntity);
+    }
+
+    // Debris is visual-only unless the portals eat it. Then it stays in Box2D as the portal food.
+    const bool debrisParticlesEnabled = utils::GetConfig<bool, "DebrisParticlesSystem.enabled">();
+    const bool isDebrisGameplayRelevant =
+        utils::GetConfig<bool, "PortalsGameLogicSystem.enabled">() && !registry.view<PortalComponent>().empty();
 
     if (utils::GetConfig<bool, "WeaponControlSystem.keepTilesAliveOnExplosion">())
     {
-        // Apply force to micro objects from the explosion center.
+        // Apply force to micro objects from the explosion centers.
         for (auto& entity : destructibleOriginalBodies)
         {
             // If entity contains PixeledTileComponent, then remove it.
             // Need to prevent dust particles from the tile. Save CPU time.
             if (registry.all_of<PixeledTileComponent>(entity))
             {
-                registryWrapper.Destroy(entity);
+                commandBuffer.Destroy(entity);
                 continue;
             }
 
-            physicsBodyTuner.ApplyOption(entity, Box2dBodyOptions::MovementPolicy::Box2dPhysics);
-            // How to read: "I have own collision category Default and I want collide with Default".
-            physicsBodyTuner.ApplyOption(entity, {CollisionFlags::Default, CollisionFlags::Default});
-            registry.emplace_or_replace<ExplostionParticlesComponent>(entity);
-
             auto& physicsComponent = registry.get<PhysicsComponent>(entity);
             auto body = physicsComponent.bodyRAII->GetBody();
             auto bodyPos = body->GetPosition();
 
-            // Apply force to the body.
-            auto vec = bodyPos - contactPointPhysics;
-            vec.Normalize();
-            float force = damageComponent->force;
-            body->ApplyLinearImpulseToCenter(force * vec, true);
+            // Sum impulses of all blasts which reach the body. Apply them at once.
+            b2Vec2 impulse(0.0f, 0.0f);
+            for (const auto& blast : blasts)
+            {
+                auto vec = bodyPos - blast.centerPhysics;
+                if (vec.Length() >= blast.damageRadiusPhysics)
+                    continue;
+
+                vec.Normalize();
+                impulse += blast.force * vec;
+            }
+
+            if (debrisParticlesEnabled && !isDebrisGameplayRelevant)
+            {
+                SpawnTileDebrisParticles(entity, impulse);
+                commandBuffer.Destroy(entity);
+                continue;
+            }
+
+            physicsBodyTuner.ApplyOption(entity, Box2dBodyOptions::MovementPolicy::Box2dPhysics);
+            // How to read: "I have own collision category Default and I want collide with Default".
+            physicsBodyTuner.ApplyOption(entity, {CollisionFlags::Default, CollisionFlags::Default});
+            commandBuffer.EmplaceOrReplace<ExplostionParticlesComponent>(entity);
+            body->ApplyLinearImpulseToCenter(impulse, true);
         }
     }
     else
@@ -222,44 +448,130 @@ void WeaponControlSystem::DoExplosion(const ExplosionEntityWithContactPoint& exp
         // Destroy original objects.
         for (auto& entity : destructibleOriginalBodies)
         {
-            registryWrapper.Destroy(entity);
+            commandBuffer.Destroy(entity);
         }
     }
 
+    // Connectivity of the terrain around the craters is checked later by the TerrainIslandsSystem.
+    if (!destructibleOriginalBodies.empty())
+    {
+        auto& damagedBounds = gameState.levelOptions.damagedTerrainBox2dBounds;
+        for (const auto& blast : blasts)
+        {
+            b2Vec2 radius(blast.damageRadiusPhysics, blast.damageRadiusPhysics);
+            damagedBounds.min = b2Min(damagedBounds.min, blast.centerPhysics - radius);
+            damagedBounds.max = b2Max(damagedBounds.max, blast.centerPhysics + radius);
+        }
+    }
+
+    // Carve the craters in the bitmap terrain. Colliders of the dirty chunks are rebuilt by the BitmapTerrainSystem
+    // once per frame, so overlapping craters do not multiply the cost.
+    if (auto terrainBitmap = gameState.levelOptions.terrainBitmap)
+    {
+        size_t carvedPixels = 0;
+        for (const auto& blast : blasts)
+        {
+            glm::vec2 craterCenterWorld = coordinatesTransformer.PhysicsToWorld(blast.centerPhysics);
+            float craterRadiusWorld = coordinatesTransformer.PhysicsToWorld(blast.craterRadiusPhysics);
+            carvedPixels += terrainBitmap->CarveCircle(craterCenterWorld, craterRadiusWorld);
+        }
+        MY_LOG(debug, "[DoExplosions] Carved {} pixels of the bitmap terrain", carvedPixels);
+    }
+
+    // Fragments are spawned once per merged region.
     if (utils::GetConfig<bool, "WeaponControlSystem.createSyntheticExplosionFragments">())
     {
-        glm::vec2 fragmentsCenterWorld = coordinatesTransformer.PhysicsToWorld(contactPointPhysics);
-        float fragmentRadiusWorld = coordinatesTransformer.PhysicsToWorld(damageRadius);
-        baseObjectsFactory.SpawnFragmentsAfterExplosion(fragmentsCenterWorld, fragmentRadiusWorld);
+        for (const auto& region : regions)
+        {
+            glm::vec2 fragmentsCenterWorld = coordinatesTransformer.PhysicsToWorld(region.centerPhysics);
+            float fragmentRadiusWorld = coordinatesTransformer.PhysicsToWorld(region.radiusPhysics);
+            if (debrisParticlesEnabled)
+            {
+                baseObjectsFactory.SpawnFragmentParticlesAfterExplosion(
+                    debrisParticlesPool, fragmentsCenterWorld, fragmentRadiusWorld);
+            }
+            else
+            {
+                baseObjectsFactory.SpawnFragmentsAfterExplosion(fragmentsCenterWorld, fragmentRadiusWorld);
+            }
+        }
     }
 
-    // Destroy the explosion entity.
-    registryWrapper.Destroy(explosionEntity);
+    // Destroy the explosion entities. All destructions of the batch are applied in bulk on the next flush.
+    for (const auto& blast : blasts)
+        commandBuffer.Destroy(blast.explosionEntity);
 
-    // Play explosion sound.
-    audioSystem.PlaySoundEffect("explosion");
+    // Play explosion sound once per batch. Many simultaneous sounds are heard as one but cost a mixer channel each.
+    audioSystem.PlaySoundEffect(explosionSound);
 }
 
-void WeaponControlSystem::ProcessEntitiesQueues()
+void WeaponControlSystem::SpawnTileDebrisParticles(entt::entity tileEntity, const b2Vec2& impulse)
 {
-    for (auto entity : becomeStaticEntitiesQueue)
+    const auto& tileComponent = registry.get<TileComponent>(tileEntity);
+    if (!tileComponent.texturePtr)
+        return;
+
+    auto body = registry.get<PhysicsComponent>(tileEntity).bodyRAII->GetBody();
+    const glm::vec2 tileCenterWorld = coordinatesTransformer.PhysicsToWorld(body->GetPosition());
+    const SDL_Rect& tileTextureRect = tileComponent.textureRect;
+    if (tileTextureRect.w <= 0 || tileTextureRect.h <= 0)
+        return;
+
+    glm::vec2 direction(impulse.x, impulse.y);
+    direction = glm::length(direction) > 0.0f ? glm::normalize(direction) : glm::vec2(0.0f, -1.0f);
+
+    auto& pieceSize = utils::GetConfig<int, "DebrisParticlesSystem.pieceSize">();
+    auto& lifetime = utils::GetConfig<float, "DebrisParticlesSystem.lifetime">();
+    auto& minSpeed = utils::GetConfig<float, "DebrisParticlesSystem.minSpeed">();
+    auto& maxSpeed = utils::GetConfig<float, "DebrisParticlesSystem.maxSpeed">();
+
+    // Texture pixels to the world. Tiles are usually rendered 1:1, but the loader may scale them.
+    const float textureToWorld = tileComponent.sizeWorld.x / static_cast<float>(tileTextureRect.w);
+    const glm::vec2 tileTopLeftWorld = tileCenterWorld - tileComponent.sizeWorld / 2.0f;
+
+    for (int y = 0; y < tileTextureRect.h; y += pieceSize)
     {
-        physicsBodyTuner.ApplyOption(entity, Box2dBodyOptions::MovementPolicy::Manual);
+        for (int x = 0; x < tileTextureRect.w; x += pieceSize)
+        {
+            const SDL_Rect pieceTextureRect = {
+                tileTextureRect.x + x, tileTextureRect.y + y, std::min(pieceSize, tileTextureRect.w - x),
+                std::min(pieceSize, tileTextureRect.h - y)};
+            const glm::vec2 pieceCenterInTile(x + pieceTextureRect.w / 2.0f, y + pieceTextureRect.h / 2.0f);
+            const glm::vec2 pieceCenterWorld = tileTopLeftWorld + pieceCenterInTile * textureToWorld;
+
+            // Pieces scatter around the direction of the impulse.
+            const glm::vec2 pieceDirection = direction + utils::GetRandomCoordinateAround(glm::vec2(0.0f, 0.0f), 0.5f);
+            const glm::vec2 velocityWorld = pieceDirection * utils::Random<float>(minSpeed, maxSpeed);
+            const float pieceSizeWorld = std::max(pieceTextureRect.w, pieceTextureRect.h) * textureToWorld;
+
+            if (!debrisParticlesPool.Spawn(
+                    pieceCenterWorld, velocityWorld, lifetime, pieceSizeWorld, tileComponent.texturePtr,
+                    pieceTextureRect))
+                return;
+        }
     }
+}
 
+void WeaponControlSystem::ProcessEntitiesQueues()
+{
+    // Gather all blasts of the frame to process them in one batch.
+    std::vector<Blast> blasts;
     for (const auto& [entity, entotyWithCollisionPoint] : explosionEntitiesQueue)
     {
-        // Here was a bug. If the entity is already in the becomeStaticEntitiesQueue, then the explosion should not be
+        // Here was a bug. If the entity is already in the stickedThisStepEntities, then the explosion should not be
         // triggered. This means that the entity just hit the wall and should become static. Explosion should be on the
         // next contact.
-        if (!becomeStaticEntitiesQueue.contains(entotyWithCollisionPoint.explosionEntity))
-        {
-            DoExplosion(entotyWithCollisionPoint);
-        }
+        if (stickedThisStepEntities.contains(entotyWithCollisionPoint.explosionEntity))
+            continue;
+
+        if (auto blast = CalculateBlast(entotyWithCollisionPoint))
+            blasts.push_back(*blast);
     }
 
+    DoExplosions(blasts);
+
     explosionEntitiesQueue.clear();
-    becomeStaticEntitiesQueue.clear();
+    stickedThisStepEntities.clear();
 }
 
 void WeaponControlSystem::UpdateFireRateComponents(float deltaTime)
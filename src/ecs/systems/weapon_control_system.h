@@ -3,9 +3,11 @@
 #include <entt/entt.hpp>
 #include <utils/box2d/box2d_body_tuner.h>
 #include <utils/coordinates_transformer.h>
+#include <utils/entt/entt_command_buffer.h>
 #include <utils/entt/entt_registry_wrapper.h>
 #include <utils/factories/game_objects_factory.h>
 #include <utils/game_options.h>
+#include <utils/particles/debris_particles_pool.h>
 #include <utils/systems/audio_system.h>
 #include <utils/systems/box2d_entt_contact_listener.h>
 
@@ -16,29 +18,57 @@ class WeaponControlSystem
         entt::entity explosionEntity;
         std::optional<b2Vec2> contactPointPhysics;
     };
+public:
+    // Blast of one explosion entity. All blasts of the frame are processed in one batch.
+    struct Blast
+    {
+        entt::entity explosionEntity;
+        b2Vec2 centerPhysics;
+        float damageRadiusPhysics; // Radius to search affected bodies. Bodies are checked by their centers.
+        float craterRadiusPhysics; // Radius of the crater in the bitmap terrain.
+        float force;
+    };
 
+    // Overlapping blasts merged into one circle. Bodies are tested against the blasts of the region only.
+    struct BlastRegion
+    {
+        b2Vec2 centerPhysics;
+        float radiusPhysics;
+        std::vector<size_t> blastIndices;
+    };
+private:
     EnttRegistryWrapper& registryWrapper;
     entt::registry& registry;
     GameOptions& gameState;
+    EnttCommandBuffer& commandBuffer;
     Box2dEnttContactListener& contactListener;
     AudioSystem& audioSystem;
+    SoundEffectHandle explosionSound;
     BaseObjectsFactory& baseObjectsFactory;
+    DebrisParticlesPool& debrisParticlesPool;
     CoordinatesTransformer coordinatesTransformer;
     Box2dBodyTuner physicsBodyTuner;
 private: /////////////// Queues for entities that should be processed when Box2D calc step has complete. /////////////
     std::map<entt::entity, ExplosionEntityWithContactPoint> explosionEntitiesQueue;
-    std::set<entt::entity> becomeStaticEntitiesQueue;
+    // Sticky entities which became static during the last step. Body option is changed by the command buffer.
+    std::set<entt::entity> stickedThisStepEntities;
 public:
     WeaponControlSystem(
-        EnttRegistryWrapper& registryWrapper, Box2dEnttContactListener& contactListener, AudioSystem& audioSystem,
-        BaseObjectsFactory& baseObjectsFactory);
+        EnttRegistryWrapper& registryWrapper, EnttCommandBuffer& commandBuffer,
+        Box2dEnttContactListener& contactListener, AudioSystem& audioSystem, BaseObjectsFactory& baseObjectsFactory,
+        DebrisParticlesPool& debrisParticlesPool);
     void Update(float deltaTime);
+    // Group the blasts which damage circles overlap. Groups are transitive: a chain of blasts is one region.
+    static std::vector<BlastRegion> MergeOverlappingBlasts(const std::vector<Blast>& blasts);
 private:
     void SubscribeToContactEvents();
     void AppendToExplosionQueue(const ExplosionEntityWithContactPoint& explosionEntityWithContactPoint);
 private:
     void CheckTimerExplosionEntities();
     void ProcessEntitiesQueues();
-    void DoExplosion(const ExplosionEntityWithContactPoint& explosionEntityWithContactPoint);
+    std::optional<Blast> CalculateBlast(const ExplosionEntityWithContactPoint& explosionEntityWithContactPoint);
+    void DoExplosions(const std::vector<Blast>& blasts);
+    // Replace the tile with the visual-only pieces of its texture. Pieces fly along the impulse.
+    void SpawnTileDebrisParticles(entt::entity tileEntity, const b2Vec2& impulse);
     void UpdateFireRateComponents(float deltaTime);
 };
\ No newline at end of file
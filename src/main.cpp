@@ -1,7 +1,9 @@
 #include "utils/coordinates_transformer.h"
 #include "utils/factories/base_objects_factory.h"
 #include <ecs/systems/animation_update_system.h>
+#include <ecs/systems/bitmap_terrain_system.h>
 #include <ecs/systems/camera_control_system.h>
+#include <ecs/systems/debris_particles_system.h>
 #include <ecs/systems/debug_system.h>
 #include <ecs/systems/events_control_system.h>
 #include <ecs/systems/map_loader_system.h>
@@ -10,6 +12,7 @@
 #include <ecs/systems/portals_game_logic_system.h>
 #include <ecs/systems/render_hud_systems.h>
 #include <ecs/systems/render_world_system.h>
+#include <ecs/systems/terrain_islands_system.h>
 #include <ecs/systems/timers_control_system.h>
 #include <ecs/systems/turret_game_logic_system.h>
 #include <ecs/systems/weapon_control_system.h>
@@ -17,11 +20,15 @@
 #include <magic_enum.hpp>
 #include <my_cpp_utils/config.h>
 #include <my_cpp_utils/json_utils.h>
+#include <utils/animation_playback_pool.h>
+#include <utils/debug_tools/render_benchmark.h>
+#include <utils/entt/entt_command_buffer.h>
 #include <utils/entt/entt_registry_wrapper.h>
 #include <utils/factories/components_factory.h>
 #include <utils/factories/game_objects_factory.h>
 #include <utils/file_system.h>
 #include <utils/logger.h>
+#include <utils/particles/debris_particles_pool.h>
 
 // #include <utils/network/steam_networking_init_RAII.h>
 #include <utils/resources/resource_manager.h>
@@ -74,6 +81,9 @@ int main([[maybe_unused]] int argc, char* args[])
         MY_LOG(info, "Current directory set to: {}", execDir);
         MY_LOG(info, "Config file loaded: {}", configFilePath.string());
 
+        if (utils::GetConfig<bool, "RenderBenchmark.enabled">())
+            return RunRenderBenchmark();
+
         // #ifndef DisableSteamNetworkingSockets
         //         // Initialize the SteamNetworkingSockets library.
         //         SteamNetworkingInitRAII::Options steamNetworkingOptions;
@@ -94,6 +104,9 @@ int main([[maybe_unused]] int argc, char* args[])
         auto& gameOptions = registry.emplace<GameOptions>(
             registryWrapper.Create("GameOptions"), utils::GetConfig<GameOptions, "GameOptions">());
 
+        // Structural changes of the registry recorded by the systems. Flushed at the sync points of the main loop.
+        EnttCommandBuffer commandBuffer(registryWrapper);
+
         // Create a contact listener and subscribe it to the physics world.
         Box2dEnttContactListener contactListener(registryWrapper);
 
@@ -111,12 +124,19 @@ int main([[maybe_unused]] int argc, char* args[])
         AudioSystem audioSystem(resourceManager);
         audioSystem.PlayMusic("background_music");
 
-        ComponentsFactory componentsFactory(resourceManager);
+        // Playback state of all animations. Advanced by the AnimationUpdateSystem, read by the renderer.
+        AnimationPlaybackPool animationPlaybackPool(resourceManager.GetAnimationFrameDurations());
+
+        ComponentsFactory componentsFactory(resourceManager, animationPlaybackPool);
         BaseObjectsFactory baseObjectsFactory(registryWrapper, componentsFactory);
         GameObjectsFactory gameObjectsFactory(registryWrapper, componentsFactory, baseObjectsFactory);
 
+        // Visual-only debris. Filled by the weapon system, moved by the DebrisParticlesSystem, drawn by the renderer.
+        DebrisParticlesPool debrisParticlesPool(utils::GetConfig<size_t, "DebrisParticlesSystem.capacity">());
+
         // Create a weapon control system and subscribe it to the contact listener.
-        WeaponControlSystem weaponControlSystem(registryWrapper, contactListener, audioSystem, baseObjectsFactory);
+        WeaponControlSystem weaponControlSystem(
+            registryWrapper, commandBuffer, contactListener, audioSystem, baseObjectsFactory, debrisParticlesPool);
 
         // Create an input event manager and an event queue system.
         InputEventManager inputEventManager;
@@ -129,11 +149,18 @@ int main([[maybe_unused]] int argc, char* args[])
         GameStateControlSystem gameStateControlSystem(registryWrapper.GetRegistry(), inputEventManager);
 
         // Create a systems with no input events.
-        SdlPrimitivesRenderer primitivesRenderer(registryWrapper.GetRegistry(), renderer.get());
-        PhysicsSystem physicsSystem(registryWrapper);
+        SdlPrimitivesRenderer primitivesRenderer(registryWrapper.GetRegistry(), renderer.get(), animationPlaybackPool);
+        PhysicsSystem physicsSystem(registryWrapper, commandBuffer);
         RenderWorldSystem RenderWorldSystem(
-            registryWrapper.GetRegistry(), renderer.get(), resourceManager, primitivesRenderer);
+            registryWrapper.GetRegistry(), renderer.get(), resourceManager, primitivesRenderer, debrisParticlesPool);
         RenderHUDSystem RenderHUDSystem(registryWrapper.GetRegistry(), renderer.get(), assetsSettingsJson);
+        inputEventManager.Subscribe(
+            [&RenderWorldSystem](const InputEventManager::EventInfo& eventInfo)
+            {
+                auto eventType = eventInfo.originalEvent.type;
+                if (eventType == SDL_RENDER_TARGETS_RESET || eventType == SDL_RENDER_DEVICE_RESET)
+                    RenderWorldSystem.OnRenderReset(eventType == SDL_RENDER_DEVICE_RESET);
+            });
 
         // Auxiliary systems.
         ScreenModeControlSystem screenModeControlSystem(inputEventManager, window);
@@ -141,17 +168,21 @@ int main([[maybe_unused]] int argc, char* args[])
 
         // Load the map.
         MapLoaderSystem mapLoaderSystem(
-            registryWrapper, resourceManager, contactListener, gameObjectsFactory, baseObjectsFactory);
+            registryWrapper, commandBuffer, resourceManager, contactListener, gameObjectsFactory, baseObjectsFactory);
 
         CoordinatesTransformer coordinatesTransformer(registryWrapper.GetRegistry());
 
-        AnimationUpdateSystem animationUpdateSystem(registryWrapper.GetRegistry(), resourceManager);
+        AnimationUpdateSystem animationUpdateSystem(registryWrapper.GetRegistry(), animationPlaybackPool);
         PortalsGameLogicSystem portalsGameLogicSystem(registryWrapper.GetRegistry(), gameObjectsFactory, audioSystem);
         TurretGameLogicSystem turretGameLogicSystem(
             registryWrapper.GetRegistry(), gameObjectsFactory, coordinatesTransformer);
 
         EventsControlSystem eventsControlSystem(registryWrapper.GetRegistry());
 
+        BitmapTerrainSystem bitmapTerrainSystem(registryWrapper.GetRegistry(), baseObjectsFactory);
+        TerrainIslandsSystem terrainIslandsSystem(registryWrapper.GetRegistry(), commandBuffer, baseObjectsFactory);
+        DebrisParticlesSystem debrisParticlesSystem(registryWrapper.GetRegistry(), debrisParticlesPool);
+
         DebugSystem debugSystem(registryWrapper.GetRegistry(), baseObjectsFactory);
 
         // Set the main loop lambda.
@@ -179,24 +210,36 @@ int main([[maybe_unused]] int argc, char* args[])
             eventsControlSystem.Update();
 
             // Update the physics and post-physics systems to prepare the render.
+            bitmapTerrainSystem.Update();
             physicsSystem.Update(deltaTime);
+            commandBuffer.Flush(); // Changes recorded inside the Box2D step.
             playerControlSystem.Update(deltaTime);
             portalsGameLogicSystem.Update(deltaTime);
             turretGameLogicSystem.Update();
             weaponControlSystem.Update(deltaTime);
+            commandBuffer.Flush(); // Destructions of the explosions.
+            terrainIslandsSystem.Update();
+            commandBuffer.Flush(); // Tiles merged into the islands.
+            debrisParticlesSystem.Update(deltaTime);
             cameraControlSystem.Update(deltaTime);
 
             // Update animation.
             animationUpdateSystem.Update(deltaTime);
 
             debugSystem.Update();
+            resourceManager.CollectPrefetchedResources();
+            gameOptions.debugInfo.resourceCache = resourceManager.GetCacheStats();
 
-            // Render the scene and the HUD.
+            // Render the scene of the previous tick and the HUD. Its sprites were batched by the render thread while
+            // this tick was simulated.
             imguiSDL.startFrame();
             RenderWorldSystem.Render();
             RenderHUDSystem.Render();
             imguiSDL.finishFrame();
 
+            // End of the simulation tick. Sprite batches are built by the render thread during the next tick.
+            RenderWorldSystem.CaptureSnapshot();
+
 #ifndef __EMSCRIPTEN__
             // Cap the frame rate.
             Uint32 frameTimeMs = SDL_GetTicks() - frameStart;
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <ecs/components/rendering_components.h>
 #include <optional>
 #include <vector>
@@ -13,4 +14,5 @@ struct Animation
 {
     std::vector<AnimationFrame> frames; // Frames of the animation.
     std::optional<SDL_Rect> hitboxRect; // Hitbox of the animation.
+    uint32_t firstFrameInTable = 0; // Index of the first frame in the flat table of the frame durations.
 };
@@ -0,0 +1,88 @@
+#include "animation_playback_pool.h"
+
+namespace
+{
+
+// Arrays never overlap. Without __restrict on the parameters the compiler can't vectorize the loop because of the
+// gather of the durations.
+void AdvanceKernel(
+    size_t count, float deltaTime, const float* __restrict durations, float* __restrict times,
+    const float* __restrict speeds, uint32_t* __restrict frames, const uint32_t* __restrict firsts,
+    const uint32_t* __restrict counts, int32_t* __restrict playing, const int32_t* __restrict looped)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float frameTime = times[i] + deltaTime * speeds[i] * 0.5f * static_cast<float>(playing[i]);
+        const float duration = durations[firsts[i] + frames[i]];
+
+        // Stopped slot keeps its frame even if the time left from the last frame exceeds the first one.
+        const int32_t isFrameOver = (frameTime >= duration) & playing[i];
+        const uint32_t nextFrame = frames[i] + isFrameOver;
+        const uint32_t isWrapped = nextFrame >= counts[i];
+
+        times[i] = frameTime - duration * static_cast<float>(isFrameOver);
+        frames[i] = nextFrame * (1 - isWrapped);
+
+        // Not looped animation stops on the first frame after the last one.
+        playing[i] = playing[i] & (looped[i] | (1 - isWrapped));
+    }
+}
+
+} // namespace
+
+AnimationPlaybackPool::AnimationPlaybackPool(const std::vector<float>& frameDurations)
+  : frameDurations(frameDurations)
+{}
+
+uint32_t AnimationPlaybackPool::Acquire(const Animation& clip, bool loop)
+{
+    uint32_t slot;
+    if (!freeSlots.empty())
+    {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else
+    {
+        slot = static_cast<uint32_t>(frameTimes.size());
+        frameTimes.push_back(0.0f);
+        speedFactors.push_back(1.0f);
+        frameIndices.push_back(0);
+        firstFrames.push_back(0);
+        framesCounts.push_back(0);
+        isPlaying.push_back(0);
+        isLooped.push_back(0);
+    }
+
+    speedFactors[slot] = 1.0f;
+    isPlaying[slot] = 1;
+    isLooped[slot] = loop ? 1 : 0;
+    SetClip(slot, clip);
+    return slot;
+}
+
+void AnimationPlaybackPool::Release(uint32_t slot)
+{
+    if (slot == invalidSlot)
+        return;
+
+    // The frame of the stopped animation is still valid, so the slot is safe to advance.
+    isPlaying[slot] = 0;
+    freeSlots.push_back(slot);
+}
+
+void AnimationPlaybackPool::SetClip(uint32_t slot, const Animation& clip)
+{
+    // Clips without frames have one endless frame in the table. Advance doesn't need to check them.
+    frameTimes[slot] = 0.0f;
+    frameIndices[slot] = 0;
+    firstFrames[slot] = clip.firstFrameInTable;
+    framesCounts[slot] = clip.frames.empty() ? 1 : static_cast<uint32_t>(clip.frames.size());
+}
+
+void AnimationPlaybackPool::Advance(float deltaTime)
+{
+    AdvanceKernel(
+        frameTimes.size(), deltaTime, frameDurations.data(), frameTimes.data(), speedFactors.data(),
+        frameIndices.data(), firstFrames.data(), framesCounts.data(), isPlaying.data(), isLooped.data());
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+#include <utils/animation.h>
+#include <vector>
+
+// Playback state of all animations in the structure of arrays. Slots are owned by the AnimationComponents.
+// Durations of the frames are read from the flat table of the ResourceManager, so the clips are not touched while
+// the animations advance. The loop in Advance has no branches and may be auto-vectorized by the compiler.
+class AnimationPlaybackPool
+{
+    const std::vector<float>& frameDurations; // Indexed by Animation::firstFrameInTable + frame index.
+    std::vector<float> frameTimes; // Time in seconds from the start of the current frame.
+    std::vector<float> speedFactors;
+    std::vector<uint32_t> frameIndices;
+    std::vector<uint32_t> firstFrames; // Index of the first frame of the clip in `frameDurations`.
+    std::vector<uint32_t> framesCounts;
+    // 0 or 1. Same width as the other arrays instead of bools, so the flags are used in the arithmetic of the lanes.
+    std::vector<int32_t> isPlaying;
+    std::vector<int32_t> isLooped;
+    std::vector<uint32_t> freeSlots; // Released slots are reused. Their animations are stopped.
+public:
+    static constexpr uint32_t invalidSlot = UINT32_MAX;
+    explicit AnimationPlaybackPool(const std::vector<float>& frameDurations);
+    // Start the clip from the first frame in a new slot.
+    uint32_t Acquire(const Animation& clip, bool loop = true);
+    void Release(uint32_t slot);
+    // Start the clip from the first frame in the existing slot.
+    void SetClip(uint32_t slot, const Animation& clip);
+    void SetSpeedFactor(uint32_t slot, float speedFactor) { speedFactors[slot] = speedFactor; }
+    // Advance all playing animations. Each animation moves by one frame at most.
+    void Advance(float deltaTime);
+public: ///////////////////////////////////////////////// Access. ////////////////////////////////////////////////
+    [[nodiscard]] size_t GetFrameIndex(uint32_t slot) const { return slot == invalidSlot ? 0 : frameIndices[slot]; }
+    [[nodiscard]] bool IsPlaying(uint32_t slot) const { return slot != invalidSlot && isPlaying[slot]; }
+    [[nodiscard]] size_t GetActiveCount() const { return frameTimes.size() - freeSlots.size(); }
+};
@@ -16,6 +16,7 @@ struct Box2dBodyOptions
         Box,
         Capsule,
         Circle,
+        Custom, // Fixtures are added by the owner of the body (e.g. chain loops of the terrain). Tuner keeps them.
     } shape = Shape::Box;
 
     enum class Sensor
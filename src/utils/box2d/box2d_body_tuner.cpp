@@ -57,6 +57,10 @@ void Box2dBodyTuner::ApplyOption(entt::entity entity, const Box2dBodyOptions::Sh
     auto body = physicsComponent.bodyRAII->GetBody();
     physicsComponent.options.shape = option;
 
+    // Custom fixtures are owned by the caller. See SetChainLoops.
+    if (option == Box2dBodyOptions::Shape::Custom)
+        return;
+
     RemoveAllFixturesExceptSensorsFromTheBody(body);
 
     auto fixtureDef = CalcFixtureDefFromOptions(physicsComponent.options.fixture);
@@ -92,6 +96,7 @@ void Box2dBodyTuner::ApplyOption(entt::entity entity, const Box2dBodyOptions::Mo
     auto& physicsComponent = GetPhysicsComponent(entity);
     auto body = physicsComponent.bodyRAII->GetBody();
     physicsComponent.options.dynamic = option;
+    const b2BodyType previousType = body->GetType();
 
     switch (option)
     {
@@ -107,6 +112,10 @@ void Box2dBodyTuner::ApplyOption(entt::entity entity, const Box2dBodyOptions::Mo
         body->SetType(b2_dynamicBody);
         break;
     }
+
+    // Listeners of on_update<PhysicsComponent> are notified about the body type change. E.g. the static tiles cache.
+    if (body->GetType() != previousType)
+        registry.patch<PhysicsComponent>(entity);
 }
 
 void Box2dBodyTuner::ApplyOption(entt::entity entity, const Box2dBodyOptions::AnglePolicy& option)
@@ -165,6 +174,66 @@ void Box2dBodyTuner::ApplyOption(entt::entity entity, const Box2dBodyOptions::Hi
     ApplyOption(entity, physicsComponent.options.shape);
 }
 
+/////////////////////////////////////// Custom fixtures. /////////////////////////////////////
+
+void Box2dBodyTuner::SetChainLoops(entt::entity entity, const std::vector<std::vector<glm::vec2>>& loopsWorld)
+{
+    auto& physicsComponent = GetPhysicsComponent(entity);
+    auto body = physicsComponent.bodyRAII->GetBody();
+
+    if (physicsComponent.options.shape != Box2dBodyOptions::Shape::Custom)
+        throw std::runtime_error("[SetChainLoops] Chain loops may be set only for the body with Shape::Custom");
+
+    RemoveAllFixturesExceptSensorsFromTheBody(body);
+
+    auto fixtureDef = CalcFixtureDefFromOptions(physicsComponent.options.fixture);
+    const auto& collisionPolicy = physicsComponent.options.collisionPolicy;
+    fixtureDef.filter.categoryBits = static_cast<uint16>(collisionPolicy.ownCategoryOfCollision);
+    fixtureDef.filter.maskBits = static_cast<uint16>(collisionPolicy.collideWith);
+
+    std::vector<b2Vec2> verticesPhysics;
+    for (const auto& loopWorld : loopsWorld)
+    {
+        if (loopWorld.size() < 3)
+            continue;
+
+        verticesPhysics.clear();
+        for (const auto& pointWorld : loopWorld)
+            verticesPhysics.push_back(body->GetLocalPoint(coordinatesTransformer.WorldToPhysics(pointWorld)));
+
+        b2ChainShape shape;
+        shape.CreateLoop(verticesPhysics.data(), static_cast<int32>(verticesPhysics.size()));
+        fixtureDef.shape = &shape;
+        body->CreateFixture(&fixtureDef);
+    }
+}
+
+void Box2dBodyTuner::SetBoxFixtures(entt::entity entity, const std::vector<std::pair<glm::vec2, glm::vec2>>& boxesWorld)
+{
+    auto& physicsComponent = GetPhysicsComponent(entity);
+    auto body = physicsComponent.bodyRAII->GetBody();
+
+    if (physicsComponent.options.shape != Box2dBodyOptions::Shape::Custom)
+        throw std::runtime_error("[SetBoxFixtures] Box fixtures may be set only for the body with Shape::Custom");
+
+    RemoveAllFixturesExceptSensorsFromTheBody(body);
+
+    auto fixtureDef = CalcFixtureDefFromOptions(physicsComponent.options.fixture);
+    const auto& collisionPolicy = physicsComponent.options.collisionPolicy;
+    fixtureDef.filter.categoryBits = static_cast<uint16>(collisionPolicy.ownCategoryOfCollision);
+    fixtureDef.filter.maskBits = static_cast<uint16>(collisionPolicy.collideWith);
+
+    for (const auto& [centerWorld, sizeWorld] : boxesWorld)
+    {
+        b2PolygonShape shape;
+        b2Vec2 sizePhysics = coordinatesTransformer.WorldToPhysics(sizeWorld);
+        b2Vec2 centerLocal = body->GetLocalPoint(coordinatesTransformer.WorldToPhysics(centerWorld));
+        shape.SetAsBox(sizePhysics.x / 2.0f, sizePhysics.y / 2.0f, centerLocal, 0.0f);
+        fixtureDef.shape = &shape;
+        body->CreateFixture(&fixtureDef);
+    }
+}
+
 /////////////////////////////////////// Create empty physics body. /////////////////////////////////////
 
 b2Body* Box2dBodyTuner::CreatePhysicsBodyWithNoShape(entt::entity entity, const glm::vec2& posWorld)
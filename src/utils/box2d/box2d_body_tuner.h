@@ -7,6 +7,8 @@
 #include <utils/box2d/box2d_RAII.h>
 #include <utils/box2d/box2d_body_options.h>
 #include <utils/coordinates_transformer.h>
+#include <utility>
+#include <vector>
 
 class Box2dBodyTuner
 {
@@ -29,6 +31,11 @@ public: /////////////////////////////////////////// Options setters. ///////////
     void ApplyOption(entt::entity entity, const Box2dBodyOptions::CollisionPolicy& option);
     void ApplyOption(entt::entity entity, const Box2dBodyOptions::BulletPolicy& option);
     void ApplyOption(entt::entity entity, const Box2dBodyOptions::Hitbox& hitbox);
+public: ////////////////////////// Custom fixtures. Used with Shape::Custom only. ///////////////////////////
+    // Replace all fixtures except sensors with chain loops. Loops are closed polylines in the world coordinates.
+    void SetChainLoops(entt::entity entity, const std::vector<std::vector<glm::vec2>>& loopsWorld);
+    // Replace all fixtures except sensors with boxes. Each box is a pair of the center and the size in the world.
+    void SetBoxFixtures(entt::entity entity, const std::vector<std::pair<glm::vec2, glm::vec2>>& boxesWorld);
 private: ///////////////////////////////////// Create empty physics body. ///////////////////////////////////
     b2Body* CreatePhysicsBodyWithNoShape(entt::entity entity, const glm::vec2& posWorld);
 private: ////////////////////////////////// Add simple fixtures to the body. ////////////////////////////////
@@ -19,8 +19,12 @@ void Box2dUtils::ApplyForceToPhysicalBodies(
         auto originalObjPhysicsInfo = registry.get<PhysicsComponent>(entity).bodyRAII->GetBody();
         const b2Vec2& posPhysics = originalObjPhysicsInfo->GetPosition();
 
-        // Make target body as dynamic.
-        originalObjPhysicsInfo->SetType(b2_dynamicBody);
+        // Make target body as dynamic. Listeners of the body type change are notified like in Box2dBodyTuner.
+        if (originalObjPhysicsInfo->GetType() != b2_dynamicBody)
+        {
+            originalObjPhysicsInfo->SetType(b2_dynamicBody);
+            registry.patch<PhysicsComponent>(entity);
+        }
 
         // Apply force to the target.
         // Force direction is from grenade to target. Inside. This greate interesting effect.
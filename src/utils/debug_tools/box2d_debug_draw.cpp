@@ -0,0 +1,203 @@
+#include "box2d_debug_draw.h"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <utils/sdl/sdl_utils.h>
+
+namespace
+{
+
+SDL_Color ToSDLColor(const b2Color& color, float alphaFactor = 1.0f)
+{
+    return {
+        static_cast<Uint8>(color.r * 255), static_cast<Uint8>(color.g * 255), static_cast<Uint8>(color.b * 255),
+        static_cast<Uint8>(color.a * alphaFactor * 255)};
+}
+
+} // namespace
+
+Box2dDebugDraw::Box2dDebugDraw(entt::registry& registry)
+  : gameState(registry.get<GameOptions>(registry.view<GameOptions>().front())), coordinatesTransformer(registry)
+{}
+
+void Box2dDebugDraw::DrawPolygon(const b2Vec2* verticesPhysics, int32 vertexCount, const b2Color& color)
+{
+    pointsScreen.clear();
+    for (int32 i = 0; i < vertexCount; ++i)
+        pointsScreen.push_back(coordinatesTransformer.PhysicsToScreen(verticesPhysics[i]));
+    AddPolygon(ToSDLColor(color), false);
+}
+
+void Box2dDebugDraw::DrawSolidPolygon(const b2Vec2* verticesPhysics, int32 vertexCount, const b2Color& color)
+{
+    pointsScreen.clear();
+    for (int32 i = 0; i < vertexCount; ++i)
+        pointsScreen.push_back(coordinatesTransformer.PhysicsToScreen(verticesPhysics[i]));
+    AddPolygon(ToSDLColor(color), true);
+}
+
+void Box2dDebugDraw::DrawCircle(const b2Vec2& centerPhysics, float radiusPhysics, const b2Color& color)
+{
+    const glm::vec2 centerScreen = coordinatesTransformer.PhysicsToScreen(centerPhysics);
+    const float radiusScreen = coordinatesTransformer.PhysicsToScreen(radiusPhysics);
+    if (IsOutsideOfWindow(centerScreen - radiusScreen, centerScreen + radiusScreen))
+        return;
+
+    AddCirclePoints(centerScreen, radiusScreen);
+    AddPolygon(ToSDLColor(color), false);
+}
+
+void Box2dDebugDraw::DrawSolidCircle(
+    const b2Vec2& centerPhysics, float radiusPhysics, const b2Vec2& axis, const b2Color& color)
+{
+    const glm::vec2 centerScreen = coordinatesTransformer.PhysicsToScreen(centerPhysics);
+    const float radiusScreen = coordinatesTransformer.PhysicsToScreen(radiusPhysics);
+    if (IsOutsideOfWindow(centerScreen - radiusScreen, centerScreen + radiusScreen))
+        return;
+
+    const SDL_Color sdlColor = ToSDLColor(color);
+    AddCirclePoints(centerScreen, radiusScreen);
+    AddPolygon(sdlColor, true);
+    AddLine(centerScreen, centerScreen + glm::vec2(axis.x, axis.y) * radiusScreen, sdlColor);
+}
+
+void Box2dDebugDraw::DrawSegment(const b2Vec2& startPhysics, const b2Vec2& endPhysics, const b2Color& color)
+{
+    const glm::vec2 startScreen = coordinatesTransformer.PhysicsToScreen(startPhysics);
+    const glm::vec2 endScreen = coordinatesTransformer.PhysicsToScreen(endPhysics);
+    if (IsOutsideOfWindow(glm::min(startScreen, endScreen), glm::max(startScreen, endScreen)))
+        return;
+
+    AddLine(startScreen, endScreen, ToSDLColor(color));
+}
+
+void Box2dDebugDraw::DrawTransform(const b2Transform& transform)
+{
+    // Same axis length as in the Box2D testbed.
+    const float axisScale = 0.4f;
+    DrawSegment(transform.p, transform.p + axisScale * transform.q.GetXAxis(), b2Color(1.0f, 0.0f, 0.0f));
+    DrawSegment(transform.p, transform.p + axisScale * transform.q.GetYAxis(), b2Color(0.0f, 1.0f, 0.0f));
+}
+
+void Box2dDebugDraw::DrawPoint(const b2Vec2& posPhysics, float sizeScreen, const b2Color& color)
+{
+    const glm::vec2 centerScreen = coordinatesTransformer.PhysicsToScreen(posPhysics);
+    const glm::vec2 halfSize(sizeScreen / 2.0f);
+    pointsScreen.clear();
+    pointsScreen.push_back(centerScreen - halfSize);
+    pointsScreen.push_back({centerScreen.x + halfSize.x, centerScreen.y - halfSize.y});
+    pointsScreen.push_back(centerScreen + halfSize);
+    pointsScreen.push_back({centerScreen.x - halfSize.x, centerScreen.y + halfSize.y});
+    AddPolygon(ToSDLColor(color), true);
+}
+
+void Box2dDebugDraw::DrawRect(const glm::vec2& centerWorld, const glm::vec2& sizeWorld, float angle, ColorName color)
+{
+    const glm::vec2 centerScreen = coordinatesTransformer.WorldToScreen(centerWorld);
+    const glm::vec2 halfSizeScreen =
+        coordinatesTransformer.WorldToScreen(sizeWorld, CoordinatesTransformer::Type::Length) / 2.0f;
+
+    pointsScreen.clear();
+    pointsScreen.push_back(centerScreen - halfSizeScreen);
+    pointsScreen.push_back({centerScreen.x + halfSizeScreen.x, centerScreen.y - halfSizeScreen.y});
+    pointsScreen.push_back(centerScreen + halfSizeScreen);
+    pointsScreen.push_back({centerScreen.x - halfSizeScreen.x, centerScreen.y + halfSizeScreen.y});
+    for (auto& point : pointsScreen)
+        utils::RotatePoint(point, centerScreen, angle);
+
+    AddPolygon(GetSDLColor(color), false);
+}
+
+void Box2dDebugDraw::Flush(SDL_Renderer* renderer)
+{
+    if (!indices.empty())
+    {
+        // Filled polygons are transparent. Blend mode of the renderer is restored for the next draws.
+        SDL_BlendMode drawBlendMode;
+        SDL_GetRenderDrawBlendMode(renderer, &drawBlendMode);
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+        SDL_RenderGeometry(
+            renderer, nullptr, vertices.data(), static_cast<int>(vertices.size()), indices.data(),
+            static_cast<int>(indices.size()));
+        SDL_SetRenderDrawBlendMode(renderer, drawBlendMode);
+    }
+
+    vertices.clear();
+    indices.clear();
+}
+
+//////////////////////// Helper methods ////////////////////////
+
+void Box2dDebugDraw::AddLine(const glm::vec2& startScreen, const glm::vec2& endScreen, const SDL_Color& color)
+{
+    const glm::vec2 direction = endScreen - startScreen;
+    const float length = glm::length(direction);
+    if (length == 0.0f)
+        return;
+
+    // Line is a quad one pixel wide.
+    const glm::vec2 halfNormal = glm::vec2(-direction.y, direction.x) / length * 0.5f;
+    const int firstVertex = static_cast<int>(vertices.size());
+    for (const glm::vec2& corner :
+         {startScreen + halfNormal, endScreen + halfNormal, endScreen - halfNormal, startScreen - halfNormal})
+        vertices.push_back({{corner.x, corner.y}, color, {0.0f, 0.0f}});
+    for (int offset : {0, 1, 2, 2, 3, 0})
+        indices.push_back(firstVertex + offset);
+}
+
+void Box2dDebugDraw::AddPolygon(const SDL_Color& color, bool isFilled)
+{
+    if (pointsScreen.size() < 2)
+        return;
+
+    glm::vec2 minScreen = pointsScreen.front();
+    glm::vec2 maxScreen = pointsScreen.front();
+    for (const auto& point : pointsScreen)
+    {
+        minScreen = glm::min(minScreen, point);
+        maxScreen = glm::max(maxScreen, point);
+    }
+    if (IsOutsideOfWindow(minScreen, maxScreen))
+        return;
+
+    // Polygons of Box2D are convex, so the fan covers them.
+    if (isFilled && pointsScreen.size() >= 3)
+    {
+        const SDL_Color fillColor = {color.r, color.g, color.b, static_cast<Uint8>(color.a / 2)};
+        const int firstVertex = static_cast<int>(vertices.size());
+        for (const auto& point : pointsScreen)
+            vertices.push_back({{point.x, point.y}, fillColor, {0.0f, 0.0f}});
+        for (int i = 1; i + 1 < static_cast<int>(pointsScreen.size()); ++i)
+        {
+            indices.push_back(firstVertex);
+            indices.push_back(firstVertex + i);
+            indices.push_back(firstVertex + i + 1);
+        }
+    }
+
+    for (size_t i = 0; i < pointsScreen.size(); ++i)
+        AddLine(pointsScreen[i], pointsScreen[(i + 1) % pointsScreen.size()], color);
+}
+
+void Box2dDebugDraw::AddCirclePoints(const glm::vec2& centerScreen, float radiusScreen)
+{
+    // Small circles don't need many segments.
+    const int segmentsCount = std::clamp(static_cast<int>(radiusScreen / 2), 8, 64);
+    const float step = 2.0f * std::numbers::pi_v<float> / segmentsCount;
+
+    pointsScreen.clear();
+    for (int i = 0; i < segmentsCount; ++i)
+        pointsScreen.push_back(centerScreen + radiusScreen * glm::vec2(std::cos(i * step), std::sin(i * step)));
+}
+
+bool Box2dDebugDraw::IsOutsideOfWindow(const glm::vec2& minScreen, const glm::vec2& maxScreen) const
+{
+    const auto& windowSize = gameState.windowOptions.windowSize;
+    return maxScreen.x < 0 || maxScreen.y < 0 || minScreen.x > windowSize.x || minScreen.y > windowSize.y;
+}
+
+b2Color ToB2Color(ColorName colorName)
+{
+    const SDL_Color color = GetSDLColor(colorName);
+    return b2Color(color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, color.a / 255.0f);
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <SDL.h>
+#include <box2d/box2d.h>
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+#include <utils/coordinates_transformer.h>
+#include <utils/game_options.h>
+#include <utils/sdl/sdl_colors.h>
+#include <vector>
+
+// Debug lines and polygons collected during the frame and drawn with one SDL_RenderGeometry call.
+// Implements b2Draw, so b2World::DebugDraw may be pointed to it. Primitives outside of the window are skipped.
+class Box2dDebugDraw : public b2Draw
+{
+    GameOptions& gameState;
+    CoordinatesTransformer coordinatesTransformer;
+    std::vector<SDL_Vertex> vertices; // Arena of the frame. Capacity is kept between the frames.
+    std::vector<int> indices;
+    std::vector<glm::vec2> pointsScreen; // Scratch buffer to convert the vertices of one primitive.
+public:
+    explicit Box2dDebugDraw(entt::registry& registry);
+public: ///////////////////////////////////// b2Draw. Physics coordinates. /////////////////////////////////////
+    void DrawPolygon(const b2Vec2* verticesPhysics, int32 vertexCount, const b2Color& color) override;
+    void DrawSolidPolygon(const b2Vec2* verticesPhysics, int32 vertexCount, const b2Color& color) override;
+    void DrawCircle(const b2Vec2& centerPhysics, float radiusPhysics, const b2Color& color) override;
+    void DrawSolidCircle(
+        const b2Vec2& centerPhysics, float radiusPhysics, const b2Vec2& axis, const b2Color& color) override;
+    void DrawSegment(const b2Vec2& startPhysics, const b2Vec2& endPhysics, const b2Color& color) override;
+    void DrawTransform(const b2Transform& transform) override;
+    void DrawPoint(const b2Vec2& posPhysics, float sizeScreen, const b2Color& color) override;
+public: ///////////////////////////////////////////////// World coordinates. /////////////////////////////////////////
+    void DrawRect(const glm::vec2& centerWorld, const glm::vec2& sizeWorld, float angle, ColorName color);
+public:
+    // Draw everything collected since the last flush. Should be called once at the end of the frame.
+    void Flush(SDL_Renderer* renderer);
+private:
+    void AddLine(const glm::vec2& startScreen, const glm::vec2& endScreen, const SDL_Color& color);
+    // Closed outline of the points in `pointsScreen`. Optionally filled with the transparent color.
+    void AddPolygon(const SDL_Color& color, bool isFilled);
+    void AddCirclePoints(const glm::vec2& centerScreen, float radiusScreen);
+    [[nodiscard]] bool IsOutsideOfWindow(const glm::vec2& minScreen, const glm::vec2& maxScreen) const;
+};
+
+b2Color ToB2Color(ColorName colorName);
@@ -1,12 +1,12 @@
 #pragma once
-#include "utils/box2d/box2d_math.h"
 #include "utils/sdl/sdl_colors.h"
 #include <box2d/b2_math.h>
 #include <box2d/box2d.h>
 #include <ecs/components/physics_components.h>
 #include <entt/entt.hpp>
-#include <utils/box2d/box2d_glm_operators.h>
-#include <utils/sdl/sdl_primitives_renderer.h>
+#include <optional>
+#include <utils/debug_tools/box2d_debug_draw.h>
+#include <utils/render/camera_culler.h>
 
 namespace details
 {
@@ -20,19 +20,20 @@ enum class DrawBoudingBoxesOptions
 
 template <typename EnttViewT>
 void DrawBoudingBoxesAdvanced(
-    SdlPrimitivesRenderer& pr, CoordinatesTransformer& ct, EnttViewT view,
+    Box2dDebugDraw& dd, const CameraCuller& culler, EnttViewT view,
     DrawBoudingBoxesOptions options = DrawBoudingBoxesOptions::DrawEverythingExceptSensors,
     std::optional<ColorName> colorOpt = std::nullopt)
 {
     for (auto entity : view)
     {
-        auto color = GetRandomColorName();
-        if (colorOpt.has_value())
-            color = colorOpt.value();
+        auto color = ToB2Color(colorOpt.value_or(GetRandomColorName()));
 
         const auto& physicsInfo = view.template get<PhysicsComponent>(entity);
 
         auto body = physicsInfo.bodyRAII->GetBody();
+        if (!culler.IsVisible(body))
+            continue;
+
         for (auto fixture = body->GetFixtureList(); fixture; fixture = fixture->GetNext())
         {
             if (!(options & DrawBoudingBoxesOptions::DrawSensors))
@@ -51,21 +52,28 @@ void DrawBoudingBoxesAdvanced(
             if (shape->GetType() == b2Shape::e_circle)
             {
                 const auto circleShape = static_cast<b2CircleShape*>(shape);
-                const glm::vec2 centerWorld = ct.PhysicsToWorld(body->GetWorldPoint(circleShape->m_p));
-                float radiusWorld = ct.PhysicsToWorld(circleShape->m_radius);
-                pr.RenderCircle(centerWorld, radiusWorld, color);
+                dd.DrawCircle(body->GetWorldPoint(circleShape->m_p), circleShape->m_radius, color);
             }
             else if (shape->GetType() == b2Shape::e_polygon)
             {
                 const auto polygonShape = static_cast<b2PolygonShape*>(shape);
 
-                auto centerPhysics = body->GetWorldPoint(polygonShape->m_centroid);
-                auto rectPhysics = TranformBox2dPolygonShapeToRectagleSize(polygonShape);
-
-                auto rectangleCenterPixel = ct.PhysicsToWorld(centerPhysics);
-                auto rectangleSizePixel = ct.PhysicsToWorld(rectPhysics);
+                b2Vec2 verticesPhysics[b2_maxPolygonVertices];
+                for (int32 i = 0; i < polygonShape->m_count; ++i)
+                    verticesPhysics[i] = body->GetWorldPoint(polygonShape->m_vertices[i]);
 
-                pr.RenderRect(rectangleCenterPixel, rectangleSizePixel, body->GetAngle(), color);
+                dd.DrawPolygon(verticesPhysics, polygonShape->m_count, color);
+            }
+            else if (shape->GetType() == b2Shape::e_chain)
+            {
+                // Loops repeat the first vertex at the end, so the segments close them.
+                const auto chainShape = static_cast<b2ChainShape*>(shape);
+                for (int32 i = 0; i + 1 < chainShape->m_count; ++i)
+                {
+                    dd.DrawSegment(
+                        body->GetWorldPoint(chainShape->m_vertices[i]),
+                        body->GetWorldPoint(chainShape->m_vertices[i + 1]), color);
+                }
             }
         }
     }
@@ -75,17 +83,15 @@ void DrawBoudingBoxesAdvanced(
 
 template <typename EnttViewT>
 void DrawBoudingBoxes(
-    SdlPrimitivesRenderer& pr, CoordinatesTransformer& ct, EnttViewT view,
-    std::optional<ColorName> colorOpt = std::nullopt)
+    Box2dDebugDraw& dd, const CameraCuller& culler, EnttViewT view, std::optional<ColorName> colorOpt = std::nullopt)
 {
     details::DrawBoudingBoxesAdvanced(
-        pr, ct, view, details::DrawBoudingBoxesOptions::DrawEverythingExceptSensors, colorOpt);
+        dd, culler, view, details::DrawBoudingBoxesOptions::DrawEverythingExceptSensors, colorOpt);
 }
 
 template <typename EnttViewT>
 void DrawSensorBoxes(
-    SdlPrimitivesRenderer& pr, CoordinatesTransformer& ct, EnttViewT view,
-    std::optional<ColorName> colorOpt = std::nullopt)
+    Box2dDebugDraw& dd, const CameraCuller& culler, EnttViewT view, std::optional<ColorName> colorOpt = std::nullopt)
 {
-    details::DrawBoudingBoxesAdvanced(pr, ct, view, details::DrawBoudingBoxesOptions::DrawSensors, colorOpt);
+    details::DrawBoudingBoxesAdvanced(dd, culler, view, details::DrawBoudingBoxesOptions::DrawSensors, colorOpt);
 }
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include "render_benchmark.h"
+#include <SDL_image.h>
+#include <algorithm>
+#include <chrono>
+#include <ecs/systems/map_loader_system.h>
+#include <ecs/systems/render_world_system.h>
+#include <filesystem>
+#include <limits>
+#include <my_cpp_utils/config.h>
+#include <my_cpp_utils/json_utils.h>
+#include <utils/animation_playback_pool.h>
+#include <utils/coordinates_transformer.h>
+#include <utils/entt/entt_command_buffer.h>
+#include <utils/entt/entt_registry_wrapper.h>
+#include <utils/factories/base_objects_factory.h>
+#include <utils/factories/components_factory.h>
+#include <utils/factories/game_objects_factory.h>
+#include <utils/logger.h>
+#include <utils/particles/debris_particles_pool.h>
+#include <utils/resources/resource_manager.h>
+#include <utils/sdl/sdl_RAII.h>
+#include <utils/sdl/sdl_primitives_renderer.h>
+#include <utils/systems/box2d_entt_contact_listener.h>
+
+int RunRenderBenchmark()
+{
+    const auto framesCount = utils::GetConfig<size_t, "RenderBenchmark.frames">();
+    const auto warmUpFramesCount = utils::GetConfig<size_t, "RenderBenchmark.warmUpFrames">();
+    const auto cameraScale = utils::GetConfig<float, "RenderBenchmark.cameraScale">();
+    const auto dumpEveryNthFrame = utils::GetConfig<size_t, "RenderBenchmark.dumpEveryNthFrame">();
+    const std::filesystem::path outputDirectory = utils::GetConfig<std::string, "RenderBenchmark.outputDirectory">();
+
+    entt::registry registry;
+    EnttRegistryWrapper registryWrapper(registry);
+    auto& gameOptions = registry.emplace<GameOptions>(
+        registryWrapper.Create("GameOptions"), utils::GetConfig<GameOptions, "GameOptions">());
+    EnttCommandBuffer commandBuffer(registryWrapper);
+    Box2dEnttContactListener contactListener(registryWrapper);
+
+    // Software renderer draws to the surface in memory.
+    SDLInitializerRAII sdlInitializer(0);
+    const glm::ivec2 frameSize = gameOptions.windowOptions.windowSize;
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, frameSize.x, frameSize.y, 32, SDL_PIXELFORMAT_ABGR8888);
+    if (!surface)
+        throw std::runtime_error(MY_FMT("[RunRenderBenchmark] Failed to create the frame surface: {}", SDL_GetError()));
+    SDLSurfaceRAII frameSurface(surface);
+    SDLRendererRAII renderer(frameSurface.get());
+
+    auto assetsSettingsJson = utils::LoadJsonFromFile("assets/assets_settings.json");
+    ResourceManager resourceManager(renderer.get(), assetsSettingsJson);
+    AnimationPlaybackPool animationPlaybackPool(resourceManager.GetAnimationFrameDurations());
+    ComponentsFactory componentsFactory(resourceManager, animationPlaybackPool);
+    BaseObjectsFactory baseObjectsFactory(registryWrapper, componentsFactory);
+    GameObjectsFactory gameObjectsFactory(registryWrapper, componentsFactory, baseObjectsFactory);
+    DebrisParticlesPool debrisParticlesPool(utils::GetConfig<size_t, "DebrisParticlesSystem.capacity">());
+    SdlPrimitivesRenderer primitivesRenderer(registry, renderer.get(), animationPlaybackPool);
+    RenderWorldSystem renderWorldSystem(
+        registry, renderer.get(), resourceManager, primitivesRenderer, debrisParticlesPool);
+    MapLoaderSystem mapLoaderSystem(
+        registryWrapper, commandBuffer, resourceManager, contactListener, gameObjectsFactory, baseObjectsFactory);
+    CoordinatesTransformer coordinatesTransformer(registry);
+
+    mapLoaderSystem.LoadMap(resourceManager.GetTiledLevel(gameOptions.levelOptions.mapName));
+    commandBuffer.Flush();
+
+    if (dumpEveryNthFrame > 0)
+        std::filesystem::create_directories(outputDirectory);
+
+    // Camera flies along the diagonal of the level. The world is not simulated, so every run renders the same frames.
+    const auto& levelBounds = gameOptions.levelOptions.levelBox2dBounds;
+    const glm::vec2 pathStartWorld = coordinatesTransformer.PhysicsToWorld(levelBounds.min);
+    const glm::vec2 pathEndWorld = coordinatesTransformer.PhysicsToWorld(levelBounds.max);
+    gameOptions.windowOptions.cameraScale = cameraScale;
+    auto renderFrame = [&](size_t frame, size_t pathFramesCount)
+    {
+        const float pathPos = pathFramesCount > 1 ? static_cast<float>(frame) / (pathFramesCount - 1) : 0.0f;
+        gameOptions.windowOptions.cameraCenterSdl = glm::mix(pathStartWorld, pathEndWorld, pathPos);
+        renderWorldSystem.CaptureSnapshot();
+        renderWorldSystem.Render();
+        SDL_RenderPresent(renderer.get());
+    };
+
+    // Static chunks are baked and textures are uploaded on the first frames. Warm-up frames fly the same path, so
+    // the measured frames don't pay for it.
+    for (size_t frame = 0; frame < warmUpFramesCount; ++frame)
+        renderFrame(frame, warmUpFramesCount);
+
+    double totalMs = 0;
+    double minMs = std::numeric_limits<double>::max();
+    double maxMs = 0;
+    size_t totalDrawCalls = 0;
+    size_t totalDrawnEntities = 0;
+    size_t totalCulledEntities = 0;
+    for (size_t frame = 0; frame < framesCount; ++frame)
+    {
+        const auto frameStart = std::chrono::steady_clock::now();
+        renderFrame(frame, framesCount);
+        const double frameMs =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
+
+        totalMs += frameMs;
+        minMs = std::min(minMs, frameMs);
+        maxMs = std::max(maxMs, frameMs);
+        totalDrawCalls += gameOptions.debugInfo.drawCalls;
+        totalDrawnEntities += gameOptions.debugInfo.drawnEntities;
+        totalCulledEntities += gameOptions.debugInfo.culledEntities;
+
+        if (dumpEveryNthFrame > 0 && frame % dumpEveryNthFrame == 0)
+        {
+            auto framePath = outputDirectory / MY_FMT("frame_{:05}.png", frame);
+            if (IMG_SavePNG(frameSurface.get(), framePath.string().c_str()) != 0)
+                throw std::runtime_error(
+                    MY_FMT("[RunRenderBenchmark] Failed to save {}: {}", framePath.string(), IMG_GetError()));
+        }
+    }
+
+    if (framesCount == 0)
+        return 0;
+
+    const double frames = static_cast<double>(framesCount);
+    MY_LOG(
+        info, "[RenderBenchmark] {} frame(s) of '{}' at {}x{}: {:.3f} ms/frame (min {:.3f}, max {:.3f})", framesCount,
+        gameOptions.levelOptions.mapName, frameSize.x, frameSize.y, totalMs / frames, minMs, maxMs);
+    MY_LOG(
+        info, "[RenderBenchmark] Per frame: {:.1f} draw call(s), {:.1f} drawn, {:.1f} culled", totalDrawCalls / frames,
+        totalDrawnEntities / frames, totalCulledEntities / frames);
+    return 0;
+}
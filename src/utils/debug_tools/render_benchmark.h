@@ -0,0 +1,6 @@
+#pragma once
+
+// Render the level offscreen with the software renderer along a fixed camera path. Frame times and draw calls are
+// logged, every Nth frame may be saved as PNG to compare pixels before and after a rendering change.
+// No window and no GPU are needed. Return the exit code of the application.
+int RunRenderBenchmark();
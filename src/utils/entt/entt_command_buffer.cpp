@@ -0,0 +1,66 @@
+#include "entt_command_buffer.h"
+#include <algorithm>
+#include <utils/logger.h>
+
+EnttCommandBuffer::EnttCommandBuffer(EnttRegistryWrapper& registryWrapper)
+  : registryWrapper(registryWrapper), registry(registryWrapper.GetRegistry()), bodyTuner(registry)
+{}
+
+DeferredEntity EnttCommandBuffer::Create(const std::string& name)
+{
+    createCommands.push_back(name);
+    return static_cast<DeferredEntity>(createCommands.size() - 1);
+}
+
+void EnttCommandBuffer::Destroy(entt::entity entity)
+{
+    destroyCommands.push_back(entity);
+}
+
+void EnttCommandBuffer::Flush()
+{
+    // Commands may record new commands while flushing. They are applied on the next flush.
+    auto creates = std::move(createCommands);
+    auto changes = std::move(changeCommands);
+    auto destroys = std::move(destroyCommands);
+    createCommands.clear();
+    changeCommands.clear();
+    destroyCommands.clear();
+
+    // Created entities are indexed by their DeferredEntity handles.
+    std::vector<entt::entity> createdEntities;
+    createdEntities.reserve(creates.size());
+    for (const auto& name : creates)
+        createdEntities.push_back(registryWrapper.Create(name));
+
+    // Sorted for the lookup of the destroyed entities below. Duplicates are removed.
+    std::sort(destroys.begin(), destroys.end());
+    destroys.erase(std::unique(destroys.begin(), destroys.end()), destroys.end());
+
+    // Changes are applied in the order of recording. Changes of the entities which are destroyed in the same flush are
+    // skipped.
+    for (auto& changeCommand : changes)
+    {
+        auto deferredEntity = std::get_if<DeferredEntity>(&changeCommand.target);
+        const entt::entity entity = deferredEntity ? createdEntities[static_cast<size_t>(*deferredEntity)]
+                                                   : std::get<entt::entity>(changeCommand.target);
+        if (!registry.valid(entity) || std::binary_search(destroys.begin(), destroys.end(), entity))
+            continue;
+
+        changeCommand.change(entity);
+    }
+
+    registryWrapper.Destroy(destroys);
+
+    if (!creates.empty() || !changes.empty() || !destroys.empty())
+    {
+        MY_LOG(
+            trace, "[EnttCommandBuffer] Flushed creates: {}, changes: {}, destroys: {}", creates.size(), changes.size(),
+            destroys.size());
+    }
+}
+
+bool EnttCommandBuffer::IsEmpty() const
+{
+    return createCommands.empty() && changeCommands.empty() && destroyCommands.empty();
+}
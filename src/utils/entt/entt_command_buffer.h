@@ -0,0 +1,85 @@
+#pragma once
+#include <cstdint>
+#include <entt/entt.hpp>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <utils/box2d/box2d_body_tuner.h>
+#include <utils/entt/entt_registry_wrapper.h>
+#include <variant>
+#include <vector>
+
+// Entity recorded by EnttCommandBuffer::Create. It exists only after the flush, so the commands recorded for it refer
+// to it by the order of creation. Valid until the next flush.
+enum class DeferredEntity : uint32_t
+{
+};
+
+// Deferred structural changes of the registry and Box2D bodies. Commands may be recorded anywhere: inside the view
+// iteration or inside Box2D callbacks where the world is locked. Commands are applied at the sync points of the main
+// loop by `Flush`. Order of the flush: creations, component and body option changes in the order of recording, then
+// destructions.
+class EnttCommandBuffer
+{
+    using EntityCommand = std::function<void(entt::entity)>;
+
+    struct ChangeCommand
+    {
+        std::variant<entt::entity, DeferredEntity> target;
+        EntityCommand change;
+    };
+
+    EnttRegistryWrapper& registryWrapper;
+    entt::registry& registry;
+    Box2dBodyTuner bodyTuner;
+    std::vector<std::string> createCommands; // Names of the entities. Indexed by DeferredEntity.
+    std::vector<ChangeCommand> changeCommands;
+    std::vector<entt::entity> destroyCommands;
+public:
+    explicit EnttCommandBuffer(EnttRegistryWrapper& registryWrapper);
+    EnttCommandBuffer(const EnttCommandBuffer&) = delete;
+    EnttCommandBuffer& operator=(const EnttCommandBuffer&) = delete;
+public: /////////////////////////////////////////////// Recording. ///////////////////////////////////////////////
+    // Components of the new entity are recorded with the returned handle.
+    DeferredEntity Create(const std::string& name);
+    // Entity may be recorded several times. It is destroyed once.
+    void Destroy(entt::entity entity);
+    // `Entity` is entt::entity or DeferredEntity.
+    template <typename Component, typename Entity>
+    void EmplaceOrReplace(Entity entity, Component component = {});
+    template <typename Component, typename Entity>
+    void Remove(Entity entity);
+    // Any option accepted by Box2dBodyTuner::ApplyOption.
+    template <typename Option>
+    void ApplyOption(entt::entity entity, const Option& option);
+public: ///////////////////////////////////////////////// Flush. ////////////////////////////////////////////////
+    // Must not be called inside the Box2D step or inside the iteration over the registry.
+    void Flush();
+    [[nodiscard]] bool IsEmpty() const;
+};
+
+template <typename Component, typename Entity>
+void EnttCommandBuffer::EmplaceOrReplace(Entity entity, Component component)
+{
+    changeCommands.push_back(
+        {entity,
+         [this, component = std::move(component)](entt::entity target) mutable
+         {
+             if constexpr (std::is_empty_v<Component>)
+                 registry.emplace_or_replace<Component>(target);
+             else
+                 registry.emplace_or_replace<Component>(target, std::move(component));
+         }});
+}
+
+template <typename Component, typename Entity>
+void EnttCommandBuffer::Remove(Entity entity)
+{
+    changeCommands.push_back({entity, [this](entt::entity target) { registry.remove<Component>(target); }});
+}
+
+template <typename Option>
+void EnttCommandBuffer::ApplyOption(entt::entity entity, const Option& option)
+{
+    changeCommands.push_back({entity, [this, option](entt::entity target) { bodyTuner.ApplyOption(target, option); }});
+}
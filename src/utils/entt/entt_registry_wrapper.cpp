@@ -30,6 +30,21 @@ void EnttRegistryWrapper::Destroy(entt::entity entity)
         registry.destroy(entity);
 }
 
+void EnttRegistryWrapper::Destroy(std::vector<entt::entity> entities)
+{
+    std::erase_if(entities, [this](entt::entity entity) { return !registry.valid(entity); });
+#ifdef MY_DEBUG
+    for (auto entity : entities)
+    {
+        auto& name = entityNamesById[entity];
+        MY_LOG(debug, "Destroying entity id: {:>6} with name: {}", entity, name);
+        removedEntityNamesById[entity] = name;
+        entityNamesById.erase(entity);
+    }
+#endif // MY_DEBUG
+    registry.destroy(entities.begin(), entities.end());
+}
+
 entt::registry& EnttRegistryWrapper::GetRegistry()
 {
     return registry;
@@ -1,5 +1,6 @@
 #pragma once
 #include <entt/entt.hpp>
+#include <vector>
 
 class EnttRegistryWrapper
 {
@@ -13,6 +14,8 @@ public:
 public: /////////////// Methods for debug - use in client code. /////////////
     entt::entity Create(const std::string& name);
     void Destroy(entt::entity entity);
+    // Destroy unique entities in bulk. Not valid entities are skipped.
+    void Destroy(std::vector<entt::entity> entities);
     void LogAllEntitiesByTheirNames();
     std::string TryGetName(entt::entity entity);
     // Get original registry.
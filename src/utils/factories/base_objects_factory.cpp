@@ -6,6 +6,7 @@
 #include <ecs/components/player_components.h>
 #include <ecs/components/portal_components.h>
 #include <ecs/components/rendering_components.h>
+#include <ecs/components/terrain_components.h>
 #include <ecs/components/turret_component.h>
 #include <ecs/components/weapon_components.h>
 #include <entt/entity/entity.hpp>
@@ -27,19 +28,27 @@
 BaseObjectsFactory::BaseObjectsFactory(EnttRegistryWrapper& registryWrapper, ComponentsFactory& componentsFactory)
   : registryWrapper(registryWrapper), registry(registryWrapper.GetRegistry()),
     gameState(registry.get<GameOptions>(registry.view<GameOptions>().front())), box2dBodyCreator(registry),
-    coordinatesTransformer(registry), bodyTuner(registry), componentsFactory(componentsFactory)
+    coordinatesTransformer(registry), bodyTuner(registry), componentsFactory(componentsFactory),
+    explosionFragmentClips(componentsFactory.ResolveAnimationClipGroup("explosionFragments", "Fragment[\\d]+"))
 {}
 
 entt::entity BaseObjectsFactory::SpawnTile(
     glm::vec2 posWorld, float sizeWorld, const TextureRect& textureRect, SpawnTileOption tileOptions,
     const std::string& name)
+{
+    return SpawnTile(posWorld, glm::vec2(sizeWorld, sizeWorld), textureRect, tileOptions, name);
+}
+
+entt::entity BaseObjectsFactory::SpawnTile(
+    glm::vec2 posWorld, const glm::vec2& sizeWorld, const TextureRect& textureRect, SpawnTileOption tileOptions,
+    const std::string& name)
 {
     auto& gap = utils::GetConfig<float, "ObjectsFactory.gapBetweenPhysicalAndVisual">();
-    glm::vec2 bodySizeWorld(sizeWorld - gap, sizeWorld - gap);
+    glm::vec2 bodySizeWorld = sizeWorld - gap;
 
     auto entity = registryWrapper.Create(name);
     registry.emplace<TileComponent>(
-        entity, glm::vec2(sizeWorld, sizeWorld), textureRect.texture, textureRect.rect, tileOptions.zOrderingType);
+        entity, sizeWorld, textureRect.texture, textureRect.rect, tileOptions.zOrderingType);
 
     Box2dBodyOptions options;
     options.fixture.restitution = 0.05f;
@@ -74,10 +83,160 @@ entt::entity BaseObjectsFactory::SpawnTile(
     return entity;
 }
 
+entt::entity BaseObjectsFactory::SpawnRenderOnlyTile(
+    glm::vec2 posWorld, float sizeWorld, const TextureRect& textureRect, ZOrderingType zOrderingType,
+    const std::string& name)
+{
+    auto entity = registryWrapper.Create(name);
+    registry.emplace<TileComponent>(
+        entity, glm::vec2(sizeWorld, sizeWorld), textureRect.texture, textureRect.rect, zOrderingType);
+    registry.emplace<RenderOnlyTileComponent>(entity, posWorld);
+    return entity;
+}
+
+entt::entity BaseObjectsFactory::SpawnQuadTreeTile(
+    glm::vec2 posWorld, const glm::vec2& sizeWorld, const TextureRect& textureRect,
+    std::shared_ptr<SDLSurfaceRAII> surface, SpawnTileOption tileOptions)
+{
+    auto entity = SpawnTile(posWorld, sizeWorld, textureRect, tileOptions, "QuadTreeTile");
+    registry.emplace<QuadTreeTileComponent>(entity, std::move(surface));
+    return entity;
+}
+
+entt::entity BaseObjectsFactory::SpawnTerrainChunk(
+    const glm::vec2& posWorld, const glm::vec2& sizeWorld, size_t chunkIndex)
+{
+    auto entity = registryWrapper.Create("TerrainChunk");
+    registry.emplace<TerrainChunkComponent>(entity, chunkIndex);
+    registry.emplace<CollidableComponent>(entity);
+
+    Box2dBodyOptions options;
+    options.fixture.restitution = 0.05f;
+    options.shape = Box2dBodyOptions::Shape::Custom;
+    options.dynamic = Box2dBodyOptions::MovementPolicy::Manual;
+    options.anglePolicy = Box2dBodyOptions::AnglePolicy::Fixed;
+    float angle = 0.0f;
+    box2dBodyCreator.CreatePhysicsBody(entity, posWorld, sizeWorld, angle, options);
+
+    return entity;
+}
+
+entt::entity BaseObjectsFactory::SpawnIndestructibleTerrain(const glm::vec2& posWorld, const glm::vec2& sizeWorld)
+{
+    auto entity = registryWrapper.Create("IndestructibleTerrain");
+    registry.emplace<IndestructibleComponent>(entity);
+    registry.emplace<CollidableComponent>(entity);
+
+    Box2dBodyOptions options;
+    options.fixture.restitution = 0.05f;
+    options.shape = Box2dBodyOptions::Shape::Custom;
+    options.dynamic = Box2dBodyOptions::MovementPolicy::Manual;
+    options.anglePolicy = Box2dBodyOptions::AnglePolicy::Fixed;
+    float angle = 0.0f;
+    box2dBodyCreator.CreatePhysicsBody(entity, posWorld, sizeWorld, angle, options);
+
+    return entity;
+}
+
+entt::entity BaseObjectsFactory::SpawnTerrainIsland(const std::vector<entt::entity>& tileEntities)
+{
+    if (tileEntities.empty())
+        throw std::runtime_error("[SpawnTerrainIsland] Island must contain at least one tile");
+
+    // Collect tiles and their bounds. Body is placed at the center of the bounds.
+    std::vector<std::pair<glm::vec2, TileComponent>> tilesWorld;
+    glm::vec2 minWorld(std::numeric_limits<float>::max());
+    glm::vec2 maxWorld(std::numeric_limits<float>::lowest());
+    for (auto tileEntity : tileEntities)
+    {
+        const auto& tileComponent = registry.get<TileComponent>(tileEntity);
+        auto body = registry.get<PhysicsComponent>(tileEntity).bodyRAII->GetBody();
+        glm::vec2 tileCenterWorld = coordinatesTransformer.PhysicsToWorld(body->GetPosition());
+        minWorld = glm::min(minWorld, tileCenterWorld - tileComponent.sizeWorld / 2.0f);
+        maxWorld = glm::max(maxWorld, tileCenterWorld + tileComponent.sizeWorld / 2.0f);
+        tilesWorld.emplace_back(tileCenterWorld, tileComponent);
+    }
+    glm::vec2 islandCenterWorld = (minWorld + maxWorld) / 2.0f;
+
+    CompoundTilesComponent compoundTiles;
+    for (const auto& [tileCenterWorld, tileComponent] : tilesWorld)
+        compoundTiles.parts.push_back({tileComponent, tileCenterWorld - islandCenterWorld});
+
+    return CreateTerrainIsland(std::move(compoundTiles), islandCenterWorld, 0.0f);
+}
+
+entt::entity BaseObjectsFactory::SpawnDamagedTerrainIsland(
+    entt::entity islandEntity, const std::vector<bool>& destroyedParts)
+{
+    const auto& islandParts = registry.get<CompoundTilesComponent>(islandEntity).parts;
+    if (destroyedParts.size() != islandParts.size())
+        throw std::runtime_error("[SpawnDamagedTerrainIsland] Destroyed parts must be marked for every part");
+
+    CompoundTilesComponent compoundTiles;
+    for (size_t partIndex = 0; partIndex < islandParts.size(); ++partIndex)
+    {
+        if (!destroyedParts[partIndex])
+            compoundTiles.parts.push_back(islandParts[partIndex]);
+    }
+    if (compoundTiles.parts.empty())
+        return entt::null;
+
+    // Offsets of the parts are kept, so the remains are placed exactly where they were.
+    auto islandBody = registry.get<PhysicsComponent>(islandEntity).bodyRAII->GetBody();
+    glm::vec2 islandCenterWorld = coordinatesTransformer.PhysicsToWorld(islandBody->GetPosition());
+    auto entity = CreateTerrainIsland(std::move(compoundTiles), islandCenterWorld, islandBody->GetAngle());
+
+    auto body = registry.get<PhysicsComponent>(entity).bodyRAII->GetBody();
+    body->SetLinearVelocity(islandBody->GetLinearVelocity());
+    body->SetAngularVelocity(islandBody->GetAngularVelocity());
+    return entity;
+}
+
+entt::entity BaseObjectsFactory::CreateTerrainIsland(
+    CompoundTilesComponent compoundTiles, const glm::vec2& posWorld, float angle)
+{
+    glm::vec2 minWorld(std::numeric_limits<float>::max());
+    glm::vec2 maxWorld(std::numeric_limits<float>::lowest());
+    for (const auto& part : compoundTiles.parts)
+    {
+        minWorld = glm::min(minWorld, part.offsetWorld - part.tile.sizeWorld / 2.0f);
+        maxWorld = glm::max(maxWorld, part.offsetWorld + part.tile.sizeWorld / 2.0f);
+    }
+
+    auto entity = registryWrapper.Create("TerrainIsland");
+    registry.emplace<CollidableComponent>(entity);
+    // Explosions remove the parts inside the blasts. See WeaponControlSystem::DoExplosions.
+    registry.emplace<DestructibleComponent>(entity);
+
+    Box2dBodyOptions options;
+    options.fixture.restitution = 0.05f;
+    options.shape = Box2dBodyOptions::Shape::Custom;
+    options.dynamic = Box2dBodyOptions::MovementPolicy::Box2dPhysics;
+    options.anglePolicy = Box2dBodyOptions::AnglePolicy::Dynamic;
+    auto body =
+        box2dBodyCreator.CreatePhysicsBody(entity, posWorld, maxWorld - minWorld, angle, options).bodyRAII->GetBody();
+
+    // Fixtures are set by the world centers of the boxes, so the offsets are rotated with the body.
+    auto& gap = utils::GetConfig<float, "ObjectsFactory.gapBetweenPhysicalAndVisual">();
+    std::vector<std::pair<glm::vec2, glm::vec2>> boxesWorld;
+    for (const auto& part : compoundTiles.parts)
+    {
+        b2Vec2 offsetPhysics =
+            coordinatesTransformer.WorldToPhysics(part.offsetWorld, CoordinatesTransformer::Type::Length);
+        glm::vec2 partCenterWorld = coordinatesTransformer.PhysicsToWorld(body->GetWorldPoint(offsetPhysics));
+        boxesWorld.emplace_back(partCenterWorld, part.tile.sizeWorld - glm::vec2(gap, gap));
+    }
+    bodyTuner.SetBoxFixtures(entity, boxesWorld);
+
+    registry.emplace<CompoundTilesComponent>(entity, std::move(compoundTiles));
+    return entity;
+}
+
 entt::entity BaseObjectsFactory::SpawnFragmentAfterExplosion(const glm::vec2& posWorld)
 {
-    AnimationComponent fragmentAnimation = componentsFactory.CreateAnimationComponent(
-        "explosionFragments", "Fragment[\\d]+", ResourceManager::TagProps::RandomByRegex);
+    // Clip group is resolved once in the constructor. No regex matching per fragment.
+    AnimationComponent fragmentAnimation =
+        componentsFactory.CreateAnimationComponent(componentsFactory.GetRandomAnimationClip(explosionFragmentClips));
     glm::vec2 fragmentSizeWorld = fragmentAnimation.GetHitboxSize();
 
     auto entity = registryWrapper.Create("ExplosionFragment");
@@ -219,6 +378,36 @@ std::vector<entt::entity> BaseObjectsFactory::SpawnFragmentsAfterExplosion(glm::
     return fragments;
 }
 
+void BaseObjectsFactory::SpawnFragmentParticlesAfterExplosion(
+    DebrisParticlesPool& particlesPool, glm::vec2 centerWorld, float radiusWorld)
+{
+    auto& lifetime = utils::GetConfig<float, "DebrisParticlesSystem.lifetime">();
+    auto& minSpeed = utils::GetConfig<float, "DebrisParticlesSystem.minSpeed">();
+    auto& maxSpeed = utils::GetConfig<float, "DebrisParticlesSystem.maxSpeed">();
+
+    size_t fragmentsCount = static_cast<size_t>(radiusWorld * 0.2f * utils::Random<float>(1, 1.2));
+    for (size_t i = 0; i < fragmentsCount; ++i)
+    {
+        const Animation& fragmentClip = componentsFactory.GetRandomAnimationClip(explosionFragmentClips);
+        if (fragmentClip.frames.empty())
+            continue;
+
+        const auto& fragmentTile = fragmentClip.frames.front().tileComponent;
+        if (!fragmentTile.texturePtr)
+            continue;
+
+        auto fragmentRandomPosWorld = utils::GetRandomCoordinateAround(centerWorld, radiusWorld);
+        glm::vec2 direction = fragmentRandomPosWorld - centerWorld;
+        direction = glm::length(direction) > 0.0f ? glm::normalize(direction) : glm::vec2(0.0f, -1.0f);
+        glm::vec2 velocityWorld = direction * utils::Random<float>(minSpeed, maxSpeed);
+
+        if (!particlesPool.Spawn(
+                fragmentRandomPosWorld, velocityWorld, lifetime, fragmentTile.sizeWorld.x, fragmentTile.texturePtr,
+                fragmentTile.textureRect))
+            break;
+    }
+}
+
 std::vector<entt::entity> BaseObjectsFactory::SpawnSplittedPhysicalEnteties(
     const std::vector<entt::entity>& physicalEntities, SDL_Point cellSizeWorld)
 {
@@ -264,5 +453,189 @@ std::vector<entt::entity> BaseObjectsFactory::SpawnSplittedPhysicalEnteties(
         }
     }
 
+    return splittedEntities;
+}
+
+std::vector<entt::entity> BaseObjectsFactory::SpawnCraterRingPhysicalEnteties(
+    std::vector<entt::entity>& physicalEntities, SDL_Point cellSizeWorld, const std::vector<CraterWorld>& craters)
+{
+    assert(cellSizeWorld.x == cellSizeWorld.y);
+    const int cellSize = cellSizeWorld.x;
+
+    auto isRectInsideAnyCrater = [&craters](const glm::vec2& minWorld, const glm::vec2& maxWorld)
+    {
+        for (const auto& crater : craters)
+        {
+            // Rect is inside the circle if the farthest corner is inside.
+            glm::vec2 farthestCorner =
+                glm::max(glm::abs(minWorld - crater.centerWorld), glm::abs(maxWorld - crater.centerWorld));
+            if (glm::length(farthestCorner) < crater.radiusWorld)
+                return true;
+        }
+        return false;
+    };
+
+    auto isRectOutsideAllCraters = [&craters](const glm::vec2& minWorld, const glm::vec2& maxWorld)
+    {
+        for (const auto& crater : craters)
+        {
+            glm::vec2 closestPoint = glm::clamp(crater.centerWorld, minWorld, maxWorld);
+            if (glm::distance(closestPoint, crater.centerWorld) < crater.radiusWorld)
+                return false;
+        }
+        return true;
+    };
+
+    auto isPointInsideAnyCrater = [&craters](const glm::vec2& posWorld)
+    {
+        for (const auto& crater : craters)
+        {
+            if (glm::distance(posWorld, crater.centerWorld) < crater.radiusWorld)
+                return true;
+        }
+        return false;
+    };
+
+    std::vector<entt::entity> splittedEntities;
+    std::vector<entt::entity> damagedEntities;
+
+    for (auto& entity : physicalEntities)
+    {
+        if (!registry.all_of<PhysicsComponent, TileComponent>(entity))
+        {
+            damagedEntities.push_back(entity);
+            continue;
+        }
+
+        auto originalObjPhysicsInfo = registry.get<PhysicsComponent>(entity).bodyRAII->GetBody();
+        auto& originalObjRenderingInfo = registry.get<TileComponent>(entity);
+        const b2Vec2& posPhysics = originalObjPhysicsInfo->GetPosition();
+        const glm::vec2 originalObjCenterWorld = coordinatesTransformer.PhysicsToWorld(posPhysics);
+        const SDL_Rect& originalTextureRect = originalObjRenderingInfo.textureRect;
+
+        // Check if the original object is big enough to be splitted.
+        if (originalTextureRect.w <= cellSize || originalTextureRect.h <= cellSize)
+        {
+            damagedEntities.push_back(entity);
+            continue;
+        }
+
+        auto originalRectCenterInTexture = utils::GetCenterOfRect(originalTextureRect);
+        auto toCenterWorld = [&](const SDL_Rect& partTextureRect)
+        { return originalObjCenterWorld + utils::GetCenterOfRect(partTextureRect) - originalRectCenterInTexture; };
+
+        // Lazily subdivided tiles keep the surface to skip invisible quadrants.
+        std::shared_ptr<SDLSurfaceRAII> surface;
+        if (auto quadTreeTile = registry.try_get<QuadTreeTileComponent>(entity))
+            surface = quadTreeTile->surface;
+
+        // Quadtree over the cells of the tile. Only nodes crossed by a crater border are divided further.
+        // Node is a range of cells [first, last). Kept parts are appended to `parts`. The last cells are cut by the
+        // tile border if the tile size is not a multiple of the cell size.
+        // Return true if the node is kept as a whole, so the parent may collapse its children back into one part.
+        auto collectParts =
+            [&](auto& self, glm::ivec2 firstCell, glm::ivec2 lastCell, std::vector<SDL_Rect>& parts) -> bool
+        {
+            const glm::ivec2 sizeCells = lastCell - firstCell;
+            const glm::ivec2 firstPixel = firstCell * cellSize;
+            const glm::ivec2 lastPixel =
+                glm::min(lastCell * cellSize, glm::ivec2(originalTextureRect.w, originalTextureRect.h));
+            const SDL_Rect partTextureRect = {
+                originalTextureRect.x + firstPixel.x, originalTextureRect.y + firstPixel.y, lastPixel.x - firstPixel.x,
+                lastPixel.y - firstPixel.y};
+            const bool isSquare = partTextureRect.w == partTextureRect.h;
+            const glm::vec2 partCenterWorld = toCenterWorld(partTextureRect);
+            const glm::vec2 halfSizeWorld = glm::vec2(partTextureRect.w, partTextureRect.h) / 2.0f;
+            const glm::vec2 minWorld = partCenterWorld - halfSizeWorld;
+            const glm::vec2 maxWorld = partCenterWorld + halfSizeWorld;
+
+            if (isRectInsideAnyCrater(minWorld, maxWorld))
+                return false;
+
+            if (surface && IsTileInvisible(surface->get(), partTextureRect))
+                return false;
+
+            // Tiles are square. Not square remainders are divided until they become square or a single cell.
+            if (isSquare && isRectOutsideAllCraters(minWorld, maxWorld))
+            {
+                parts.push_back(partTextureRect);
+                return true;
+            }
+
+            if (sizeCells.x == 1 && sizeCells.y == 1)
+            {
+                // Same rule as for the full split: the cell is destroyed if its center is inside a crater.
+                if (isPointInsideAnyCrater(partCenterWorld))
+                    return false;
+
+                parts.push_back(partTextureRect);
+                return true;
+            }
+
+            const size_t partsCountBefore = parts.size();
+            bool areAllChildrenKept = true;
+            const glm::ivec2 middleCell = firstCell + glm::max(sizeCells / 2, glm::ivec2(1, 1));
+            for (int quadrant = 0; quadrant < 4; ++quadrant)
+            {
+                glm::ivec2 quadrantFirst(
+                    (quadrant & 1) ? middleCell.x : firstCell.x, (quadrant & 2) ? middleCell.y : firstCell.y);
+                glm::ivec2 quadrantLast(
+                    (quadrant & 1) ? lastCell.x : middleCell.x, (quadrant & 2) ? lastCell.y : middleCell.y);
+                if (quadrantFirst.x < quadrantLast.x && quadrantFirst.y < quadrantLast.y)
+                    areAllChildrenKept = self(self, quadrantFirst, quadrantLast, parts) && areAllChildrenKept;
+            }
+
+            // Uniform siblings collapse back into the parent.
+            if (areAllChildrenKept && isSquare)
+            {
+                parts.resize(partsCountBefore);
+                parts.push_back(partTextureRect);
+                return true;
+            }
+
+            return false;
+        };
+
+        std::vector<SDL_Rect> parts;
+        const glm::ivec2 cellsCount(
+            (originalTextureRect.w + cellSize - 1) / cellSize, (originalTextureRect.h + cellSize - 1) / cellSize);
+        collectParts(collectParts, glm::ivec2(0, 0), cellsCount, parts);
+
+        // Craters missed every cell of the tile. Respawning the same tile would only turn the original into debris.
+        if (parts.size() == 1 && SDL_RectEquals(&parts.front(), &originalTextureRect))
+            continue;
+
+        damagedEntities.push_back(entity);
+
+        SpawnTileOption spawnTileOptions;
+        spawnTileOptions.destructibleOption = SpawnTileOption::DesctructibleOption::Destructible;
+        spawnTileOptions.zOrderingType = ZOrderingType::Terrain;
+
+        for (const auto& partTextureRect : parts)
+        {
+            const glm::vec2 partCenterWorld = toCenterWorld(partTextureRect);
+            const glm::vec2 partSizeWorld(partTextureRect.w, partTextureRect.h);
+            const TextureRect partTexture{originalObjRenderingInfo.texturePtr, partTextureRect};
+
+            if (partTextureRect.w <= cellSize && partTextureRect.h <= cellSize)
+            {
+                auto pixelEntity =
+                    SpawnTile(partCenterWorld, partSizeWorld, partTexture, spawnTileOptions, "PixeledTile");
+                registry.emplace<PixeledTileComponent>(pixelEntity);
+                splittedEntities.push_back(pixelEntity);
+            }
+            else if (surface)
+            {
+                splittedEntities.push_back(
+                    SpawnQuadTreeTile(partCenterWorld, partSizeWorld, partTexture, surface, spawnTileOptions));
+            }
+            else
+            {
+                splittedEntities.push_back(SpawnTile(partCenterWorld, partSizeWorld, partTexture, spawnTileOptions));
+            }
+        }
+    }
+
+    physicalEntities = std::move(damagedEntities);
     return splittedEntities;
 }
\ No newline at end of file
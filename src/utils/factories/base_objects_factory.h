@@ -1,6 +1,7 @@
 #pragma once
 #include <ecs/components/animation_components.h>
 #include <ecs/components/rendering_components.h>
+#include <ecs/components/terrain_components.h>
 #include <entt/entt.hpp>
 #include <utils/box2d/box2d_body_tuner.h>
 #include <utils/coordinates_transformer.h>
@@ -8,6 +9,7 @@
 #include <utils/factories/box2d_body_creator.h>
 #include <utils/factories/components_factory.h>
 #include <utils/game_options.h>
+#include <utils/particles/debris_particles_pool.h>
 #include <utils/resources/resource_manager.h>
 #include <utils/sdl/sdl_texture_process.h>
 
@@ -20,6 +22,7 @@ class BaseObjectsFactory
     CoordinatesTransformer coordinatesTransformer;
     Box2dBodyTuner bodyTuner;
     ComponentsFactory& componentsFactory;
+    AnimationClipGroupHandle explosionFragmentClips;
 public:
     BaseObjectsFactory(EnttRegistryWrapper& registryWrapper, ComponentsFactory& componentsFactory);
 
@@ -40,10 +43,39 @@ public:
         size_t trailSize = 10;
         SpawnPolicyBase spawnPolicy = SpawnPolicyBase::This;
     };
+
+    struct CraterWorld
+    {
+        glm::vec2 centerWorld;
+        float radiusWorld;
+    };
 public: ////////////////////////////////////////////// Main game objects. ////////////////////////////////////////
     entt::entity SpawnTile(
         glm::vec2 posWorld, float sizeWorld, const TextureRect& textureRect, SpawnTileOption tileOptions,
         const std::string& name = "Tile");
+    // Not square tile. E.g. the last cell of the tile which size is not a multiple of the cell size.
+    entt::entity SpawnTile(
+        glm::vec2 posWorld, const glm::vec2& sizeWorld, const TextureRect& textureRect, SpawnTileOption tileOptions,
+        const std::string& name = "Tile");
+    // Tile of the decorative layer. No Box2D body is created. See RenderOnlyTileComponent.
+    entt::entity SpawnRenderOnlyTile(
+        glm::vec2 posWorld, float sizeWorld, const TextureRect& textureRect, ZOrderingType zOrderingType,
+        const std::string& name = "RenderOnlyTile");
+    // Tile which is subdivided into quadrants only when an explosion overlaps it. See QuadTreeTileComponent.
+    entt::entity SpawnQuadTreeTile(
+        glm::vec2 posWorld, const glm::vec2& sizeWorld, const TextureRect& textureRect,
+        std::shared_ptr<SDLSurfaceRAII> surface, SpawnTileOption tileOptions);
+    // Static body of the TerrainBitmap chunk. Chain loops are set later by the BitmapTerrainSystem.
+    entt::entity SpawnTerrainChunk(const glm::vec2& posWorld, const glm::vec2& sizeWorld, size_t chunkIndex);
+    // Static body of the indestructible pixels of the TerrainBitmap. Chain loops are set by the BitmapTerrainSystem.
+    entt::entity SpawnIndestructibleTerrain(const glm::vec2& posWorld, const glm::vec2& sizeWorld);
+    // One dynamic body with a box fixture per tile. Tiles are copied into the new entity, originals are kept.
+    // Island stays destructible, see SpawnDamagedTerrainIsland.
+    entt::entity SpawnTerrainIsland(const std::vector<entt::entity>& tileEntities);
+    // Copy of the island without the parts marked in `destroyedParts`. Parts are indexed as in CompoundTilesComponent.
+    // Remains keep the transform and the velocity of the island. Return entt::null if no part remains.
+    // The original island is kept.
+    entt::entity SpawnDamagedTerrainIsland(entt::entity islandEntity, const std::vector<bool>& destroyedParts);
 public: ///////////////////////////////////////// Debug visual objects. //////////////////////////////////////////
     // `nameAsKey` is used as a key in entt registry to search in NameComponent.
     entt::entity SpawnDebugVisualObject(
@@ -56,11 +88,23 @@ public: //////////////////////////////////////////////// Explosions. ///////////
     // Split physical entities into smaller ones. Return new entities. Used for explosion effect.
     std::vector<entt::entity> SpawnSplittedPhysicalEnteties(
         const std::vector<entt::entity>& entities, SDL_Point cellSizeWorld);
+    // Split physical entities only along the crater borders. Cells fully inside any crater are not created.
+    // Parts fully outside of all craters are kept as bigger square tiles. Return new entities.
+    // Entities which lose nothing are removed from `entities` and must be kept by the caller. Parts are collapsed only
+    // within one split, leaves of the previous explosions are not merged back.
+    std::vector<entt::entity> SpawnCraterRingPhysicalEnteties(
+        std::vector<entt::entity>& entities, SDL_Point cellSizeWorld, const std::vector<CraterWorld>& craters);
     std::vector<entt::entity> SpawnFragmentsAfterExplosion(glm::vec2 centerWorld, float radiusWorld);
+    // Same fragments as visual-only particles. No entities are created.
+    void SpawnFragmentParticlesAfterExplosion(
+        DebrisParticlesPool& particlesPool, glm::vec2 centerWorld, float radiusWorld);
 public: /////////////////////////////////////////// Explosions. Helpers. /////////////////////////////////////////
     entt::entity SpawnFragmentAfterExplosion(const glm::vec2& posWorld);
 public: ///////////////////////////////////////////// Common. Helpers. ///////////////////////////////////////////
     entt::entity SpawnFlyingEntity(
         const glm::vec2& posWorld, const glm::vec2& sizeWorld, float forceDirection, float force,
         Box2dBodyOptions::AnglePolicy anglePolicy);
+private:
+    // `parts` offsets are relative to `posWorld` when the angle is zero.
+    entt::entity CreateTerrainIsland(CompoundTilesComponent compoundTiles, const glm::vec2& posWorld, float angle);
 };
\ No newline at end of file
@@ -1,13 +1,43 @@
 #include "components_factory.h"
 
-ComponentsFactory::ComponentsFactory(ResourceManager& resourceManager) : resourceManager(resourceManager)
+ComponentsFactory::ComponentsFactory(ResourceManager& resourceManager, AnimationPlaybackPool& animationPlaybackPool)
+  : resourceManager(resourceManager), animationPlaybackPool(animationPlaybackPool)
 {}
 
 AnimationComponent ComponentsFactory::CreateAnimationComponent(
     const std::string& animationName, const std::string& tagName, ResourceManager::TagProps tagProps)
+{
+    return CreateAnimationComponent(resourceManager.GetAnimation(animationName, tagName, tagProps));
+}
+
+AnimationComponent ComponentsFactory::CreateAnimationComponent(const Animation& clip)
 {
     AnimationComponent animationInfo;
-    animationInfo.animation = resourceManager.GetAnimation(animationName, tagName, tagProps);
-    animationInfo.isPlaying = true;
+    animationInfo.clip = &clip;
+    animationInfo.playbackSlot = animationPlaybackPool.Acquire(clip);
     return animationInfo;
 }
+
+AnimationClipGroupHandle ComponentsFactory::ResolveAnimationClipGroup(
+    const std::string& animationName, const std::string& regexTagName)
+{
+    return resourceManager.ResolveAnimationClipGroup(animationName, regexTagName);
+}
+
+const Animation& ComponentsFactory::GetRandomAnimationClip(AnimationClipGroupHandle clipGroup) const
+{
+    return resourceManager.GetRandomAnimationClip(clipGroup);
+}
+
+AnimationStateMachineComponent ComponentsFactory::CreateAnimationStateMachineComponent(
+    const std::string& animationName, const std::vector<std::string>& tagNames)
+{
+    AnimationStateMachineComponent stateMachine;
+    for (const auto& tagName : tagNames)
+    {
+        auto& state = stateMachine.states.emplace_back();
+        state.name = tagName;
+        state.clip = &resourceManager.GetAnimation(animationName, tagName, ResourceManager::TagProps::ExactMatch);
+    }
+    return stateMachine;
+}
@@ -1,13 +1,25 @@
 #pragma once
 #include <ecs/components/animation_components.h>
+#include <utils/animation_playback_pool.h>
 #include <utils/resources/resource_manager.h>
 
 class ComponentsFactory
 {
     ResourceManager& resourceManager;
+    AnimationPlaybackPool& animationPlaybackPool;
 public:
-    ComponentsFactory(ResourceManager& resourceManager);
+    ComponentsFactory(ResourceManager& resourceManager, AnimationPlaybackPool& animationPlaybackPool);
 
+    // The playback slot is released when the component is destroyed. The component should be added to an entity.
     AnimationComponent CreateAnimationComponent(
         const std::string& animationName, const std::string& tagName, ResourceManager::TagProps tagProps);
+    // Same for the clip resolved before, e.g. picked from a clip group. Nothing is looked up by the name.
+    AnimationComponent CreateAnimationComponent(const Animation& clip);
+    // Clips without the playback. E.g. for the particles which show the first frame only.
+    AnimationClipGroupHandle ResolveAnimationClipGroup(
+        const std::string& animationName, const std::string& regexTagName);
+    const Animation& GetRandomAnimationClip(AnimationClipGroupHandle clipGroup) const;
+    // States are created in the order of the tags. Transitions should be added by the caller.
+    AnimationStateMachineComponent CreateAnimationStateMachineComponent(
+        const std::string& animationName, const std::vector<std::string>& tagNames);
 };
\ No newline at end of file
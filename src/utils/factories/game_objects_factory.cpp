@@ -42,6 +42,17 @@ entt::entity GameObjectsFactory::SpawnPlayer(const glm::vec2& posWorld, const st
         componentsFactory.CreateAnimationComponent("player", "Run", ResourceManager::TagProps::ExactMatch);
     registry.emplace<AnimationComponent>(entity, playerAnimation);
 
+    // Clips are swapped by the AnimationUpdateSystem only when the player starts or stops moving.
+    const size_t idleState = 0;
+    const size_t runState = 1;
+    auto& stateMachine = registry.emplace<AnimationStateMachineComponent>(
+        entity, componentsFactory.CreateAnimationStateMachineComponent("player", {"Idle", "Run"}));
+    stateMachine.states[runState].isSpeedDriven = true;
+    stateMachine.currentState = runState; // Same clip as the initial animation.
+    using Condition = AnimationStateMachineComponent::Condition;
+    stateMachine.transitions = {
+        {idleState, runState, Condition::SpeedAbove, 0.1f}, {runState, idleState, Condition::SpeedBelow, 0.1f}};
+
     // PlayerInfo.
     auto& playerInfo = registry.emplace<PlayerComponent>(entity);
     playerInfo.weapons = WeaponPropsFactory::CreateAllWeaponsSet();
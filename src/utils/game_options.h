@@ -4,7 +4,9 @@
 #include <memory>
 #include <nlohmann/json.hpp>
 #include <string>
+#include <utils/resources/resource_cache_stats.h>
 #include <utils/sdl/sdl_RAII.h>
+#include <utils/terrain/terrain_bitmap.h>
 
 struct LevelPhysicsBounds
 {
@@ -25,6 +27,10 @@ struct LevelOptions
     BackgroundInfo backgroundInfo;
     LevelPhysicsBounds levelBox2dBounds;
     b2Vec2 bufferZone{10.0f, 10.0f};
+    // Created by the map loader if the bitmap terrain or the chain colliders of the indestructible terrain are used.
+    std::shared_ptr<TerrainBitmap> terrainBitmap{};
+    // Area where the terrain was destroyed since the last connectivity check. Empty if min > max.
+    LevelPhysicsBounds damagedTerrainBox2dBounds;
 };
 
 struct WindowOptions
@@ -49,6 +55,11 @@ struct DebugInfo
 {
     float spacePressedDuration{0.0f};
     float spacePressedDurationOnUpEvent{0.0f};
+    size_t drawnEntities{0}; // Tiles and animations submitted one by one in the last frame.
+    size_t culledEntities{0}; // Tiles, islands and animations rejected by the camera culling in the last frame.
+    size_t drawCalls{0}; // Textured draw calls of the world in the last frame. Debug primitives are not counted.
+    float resolutionScale{1.0f}; // Resolution of the world relative to the window. Lowered when frames are slow.
+    ResourceCacheStats resourceCache; // Copied from the ResourceManager every frame.
 };
 
 struct GameOptions
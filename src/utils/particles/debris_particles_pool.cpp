@@ -0,0 +1,114 @@
+#include "debris_particles_pool.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+DebrisParticlesPool::DebrisParticlesPool(size_t capacity) : capacity(capacity)
+{
+    posX.resize(capacity);
+    posY.resize(capacity);
+    prevPosX.resize(capacity);
+    prevPosY.resize(capacity);
+    lifetimes.resize(capacity);
+    sizes.resize(capacity);
+    srcRects.resize(capacity);
+    textureIndices.resize(capacity);
+}
+
+bool DebrisParticlesPool::Spawn(
+    const glm::vec2& posWorld, const glm::vec2& velocityWorld, float lifetime, float sizeWorld,
+    const std::shared_ptr<SDLTextureRAII>& texture, const SDL_Rect& srcRect)
+{
+    if (count >= capacity)
+        return false;
+
+    // Textures are few (tileset, fragments), so the linear search is cheap.
+    auto textureIt = std::find(textures.begin(), textures.end(), texture);
+    if (textureIt == textures.end())
+    {
+        if (textures.size() > std::numeric_limits<uint16_t>::max())
+            throw std::runtime_error("[DebrisParticlesPool] Too many textures");
+        textureIt = textures.insert(textures.end(), texture);
+    }
+
+    const size_t i = count++;
+    posX[i] = posWorld.x;
+    posY[i] = posWorld.y;
+    prevPosX[i] = posWorld.x - velocityWorld.x * lastDeltaTime;
+    prevPosY[i] = posWorld.y - velocityWorld.y * lastDeltaTime;
+    lifetimes[i] = lifetime;
+    sizes[i] = sizeWorld;
+    srcRects[i] = srcRect;
+    textureIndices[i] = static_cast<uint16_t>(textureIt - textures.begin());
+    return true;
+}
+
+void DebrisParticlesPool::Clear()
+{
+    count = 0;
+    textures.clear();
+}
+
+void DebrisParticlesPool::Integrate(float deltaTime, const glm::vec2& gravityWorld, float airDamping)
+{
+    if (deltaTime <= 0.0f)
+        return;
+
+    // Time-corrected Verlet: x' = x + (x - prev) * (dt / prevDt) * damping + a * dt^2.
+    const float velocityScale = deltaTime / lastDeltaTime * airDamping;
+    const float accelerationX = gravityWorld.x * deltaTime * deltaTime;
+    const float accelerationY = gravityWorld.y * deltaTime * deltaTime;
+    lastDeltaTime = deltaTime;
+
+    // Plain loops over separate arrays without branches. Compilers vectorize them with -O2/-O3.
+    float* __restrict x = posX.data();
+    float* __restrict prevX = prevPosX.data();
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float current = x[i];
+        x[i] = current + (current - prevX[i]) * velocityScale + accelerationX;
+        prevX[i] = current;
+    }
+
+    float* __restrict y = posY.data();
+    float* __restrict prevY = prevPosY.data();
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float current = y[i];
+        y[i] = current + (current - prevY[i]) * velocityScale + accelerationY;
+        prevY[i] = current;
+    }
+}
+
+void DebrisParticlesPool::UpdateLifetimes(float deltaTime)
+{
+    float* __restrict remaining = lifetimes.data();
+    for (size_t i = 0; i < count; ++i)
+        remaining[i] -= deltaTime;
+
+    // Iterate backwards, so the swapped particle is already checked.
+    for (size_t i = count; i-- > 0;)
+    {
+        if (lifetimes[i] <= 0.0f)
+            RemoveBySwap(i);
+    }
+
+    if (count == 0)
+        textures.clear();
+}
+
+void DebrisParticlesPool::RemoveBySwap(size_t index)
+{
+    const size_t last = --count;
+    if (index == last)
+        return;
+
+    posX[index] = posX[last];
+    posY[index] = posY[last];
+    prevPosX[index] = prevPosX[last];
+    prevPosY[index] = prevPosY[last];
+    lifetimes[index] = lifetimes[last];
+    sizes[index] = sizes[last];
+    srcRects[index] = srcRects[last];
+    textureIndices[index] = textureIndices[last];
+}
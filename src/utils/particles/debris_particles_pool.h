@@ -0,0 +1,96 @@
+#pragma once
+#include <SDL.h>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <memory>
+#include <utils/sdl/sdl_RAII.h>
+#include <vector>
+
+// Fixed capacity pool of visual-only debris. Particles are not entities and have no Box2D bodies.
+// Structure of arrays keeps the integration loops simple enough to be auto-vectorized by the compiler.
+// Position Verlet: the velocity is stored implicitly as the difference between the current and previous positions.
+class DebrisParticlesPool
+{
+    size_t capacity;
+    size_t count = 0;
+    float lastDeltaTime = 1.0f / 60.0f; // Time step of the previous integration. Used to keep Verlet time-corrected.
+    std::vector<float> posX;
+    std::vector<float> posY;
+    std::vector<float> prevPosX;
+    std::vector<float> prevPosY;
+    std::vector<float> lifetimes; // Remaining lifetime in seconds.
+    std::vector<float> sizes; // Particles are squares. Size in the world coordinates.
+    std::vector<SDL_Rect> srcRects;
+    std::vector<uint16_t> textureIndices; // Index in `textures`.
+    std::vector<std::shared_ptr<SDLTextureRAII>> textures; // Unique textures of the particles.
+public:
+    explicit DebrisParticlesPool(size_t capacity);
+    // Return false if the pool is full. Particle is dropped in this case.
+    bool Spawn(
+        const glm::vec2& posWorld, const glm::vec2& velocityWorld, float lifetime, float sizeWorld,
+        const std::shared_ptr<SDLTextureRAII>& texture, const SDL_Rect& srcRect);
+    void Clear();
+public: /////////////////////////////////////////////// Simulation. //////////////////////////////////////////////
+    void Integrate(float deltaTime, const glm::vec2& gravityWorld, float airDamping);
+    // `isSolid(glm::vec2 posWorld)` returns true if the position is inside the terrain.
+    template <typename IsSolid>
+    void Collide(const IsSolid& isSolid, float restitution, float friction);
+    void UpdateLifetimes(float deltaTime);
+public: ///////////////////////////////////////////////// Access. ////////////////////////////////////////////////
+    [[nodiscard]] size_t GetCount() const { return count; }
+    [[nodiscard]] size_t GetCapacity() const { return capacity; }
+    [[nodiscard]] glm::vec2 GetPosition(size_t index) const { return {posX[index], posY[index]}; }
+    [[nodiscard]] float GetSize(size_t index) const { return sizes[index]; }
+    [[nodiscard]] const SDL_Rect& GetSrcRect(size_t index) const { return srcRects[index]; }
+    [[nodiscard]] uint16_t GetTextureIndex(size_t index) const { return textureIndices[index]; }
+    [[nodiscard]] const std::vector<std::shared_ptr<SDLTextureRAII>>& GetTextures() const { return textures; }
+private:
+    // Move the last particle to the `index`. Order of the particles is not preserved.
+    void RemoveBySwap(size_t index);
+};
+
+template <typename IsSolid>
+void DebrisParticlesPool::Collide(const IsSolid& isSolid, float restitution, float friction)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        const glm::vec2 pos(posX[i], posY[i]);
+        if (!isSolid(pos))
+            continue;
+
+        // Find the blocked axis by moving along each axis separately. Velocity along it is reflected.
+        const glm::vec2 prevPos(prevPosX[i], prevPosY[i]);
+        const glm::vec2 velocity = pos - prevPos;
+        const bool isBlockedX = isSolid(glm::vec2(pos.x, prevPos.y));
+        const bool isBlockedY = isSolid(glm::vec2(prevPos.x, pos.y));
+
+        // Friction acts only along the surface. In the corner both axes are reflected and friction is not applied.
+        const bool isReflectedX = isBlockedX || !isBlockedY;
+        const bool isReflectedY = isBlockedY || !isBlockedX;
+        glm::vec2 newPos = pos;
+        glm::vec2 newVelocity;
+        if (isReflectedX)
+        {
+            newPos.x = prevPos.x;
+            newVelocity.x = -velocity.x * restitution;
+        }
+        else
+        {
+            newVelocity.x = velocity.x * friction;
+        }
+        if (isReflectedY)
+        {
+            newPos.y = prevPos.y;
+            newVelocity.y = -velocity.y * restitution;
+        }
+        else
+        {
+            newVelocity.y = velocity.y * friction;
+        }
+
+        posX[i] = newPos.x;
+        posY[i] = newPos.y;
+        prevPosX[i] = newPos.x - newVelocity.x;
+        prevPosY[i] = newPos.y - newVelocity.y;
+    }
+}
@@ -0,0 +1,55 @@
+#include "occupancy_grid.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+OccupancyGrid::OccupancyGrid(const glm::vec2& minWorld, const glm::vec2& maxWorld, float cellSizeWorld)
+  : originWorld(minWorld), cellSizeWorld(cellSizeWorld)
+{
+    if (cellSizeWorld <= 0.0f || maxWorld.x <= minWorld.x || maxWorld.y <= minWorld.y)
+        throw std::runtime_error("[OccupancyGrid] Size of the grid and size of the cell must be positive");
+
+    width = static_cast<int>(std::ceil((maxWorld.x - minWorld.x) / cellSizeWorld));
+    height = static_cast<int>(std::ceil((maxWorld.y - minWorld.y) / cellSizeWorld));
+    counts.resize(static_cast<size_t>(width) * height, 0);
+}
+
+void OccupancyGrid::AddRect(const glm::vec2& minWorld, const glm::vec2& maxWorld)
+{
+    UpdateRect(minWorld, maxWorld, +1);
+}
+
+void OccupancyGrid::RemoveRect(const glm::vec2& minWorld, const glm::vec2& maxWorld)
+{
+    UpdateRect(minWorld, maxWorld, -1);
+}
+
+bool OccupancyGrid::IsOccupied(const glm::vec2& posWorld) const
+{
+    const int x = static_cast<int>(std::floor((posWorld.x - originWorld.x) / cellSizeWorld));
+    const int y = static_cast<int>(std::floor((posWorld.y - originWorld.y) / cellSizeWorld));
+    if (x < 0 || y < 0 || x >= width || y >= height)
+        return false;
+
+    return counts[static_cast<size_t>(y) * width + x] > 0;
+}
+
+void OccupancyGrid::UpdateRect(const glm::vec2& minWorld, const glm::vec2& maxWorld, int delta)
+{
+    // Cell (x, y) center is originWorld + (x + 0.5) * cellSizeWorld.
+    const glm::vec2 minCell = (minWorld - originWorld) / cellSizeWorld - glm::vec2(0.5f);
+    const glm::vec2 maxCell = (maxWorld - originWorld) / cellSizeWorld - glm::vec2(0.5f);
+    const int minX = std::max(static_cast<int>(std::ceil(minCell.x)), 0);
+    const int minY = std::max(static_cast<int>(std::ceil(minCell.y)), 0);
+    const int maxX = std::min(static_cast<int>(std::floor(maxCell.x)), width - 1);
+    const int maxY = std::min(static_cast<int>(std::floor(maxCell.y)), height - 1);
+
+    for (int y = minY; y <= maxY; ++y)
+    {
+        for (int x = minX; x <= maxX; ++x)
+        {
+            auto& count = counts[static_cast<size_t>(y) * width + x];
+            count = static_cast<uint16_t>(std::max(static_cast<int>(count) + delta, 0));
+        }
+    }
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+// Coarse occupancy of the static terrain made of tiles. Cell stores the number of rects which cover it, so
+// overlapping rects may be added and removed in any order.
+class OccupancyGrid
+{
+    glm::vec2 originWorld;
+    float cellSizeWorld;
+    int width;
+    int height;
+    std::vector<uint16_t> counts;
+public:
+    OccupancyGrid(const glm::vec2& minWorld, const glm::vec2& maxWorld, float cellSizeWorld);
+    // Cells are covered if their centers are inside the rect.
+    void AddRect(const glm::vec2& minWorld, const glm::vec2& maxWorld);
+    void RemoveRect(const glm::vec2& minWorld, const glm::vec2& maxWorld);
+    // Positions outside of the grid are not occupied.
+    [[nodiscard]] bool IsOccupied(const glm::vec2& posWorld) const;
+private:
+    void UpdateRect(const glm::vec2& minWorld, const glm::vec2& maxWorld, int delta);
+};
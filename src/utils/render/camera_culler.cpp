@@ -0,0 +1,159 @@
+#include "camera_culler.h"
+#include <algorithm>
+#include <cmath>
+#include <ecs/components/physics_components.h>
+#include <ecs/components/rendering_components.h>
+#include <my_cpp_utils/config.h>
+
+namespace
+{
+
+class CollectBodiesQueryCallback : public b2QueryCallback
+{
+    std::vector<entt::entity>& entities;
+public:
+    explicit CollectBodiesQueryCallback(std::vector<entt::entity>& entities) : entities(entities) {}
+
+    bool ReportFixture(b2Fixture* fixture) override
+    {
+        // Entity is stored in the body by the Box2dBodyTuner.
+        entities.push_back(static_cast<entt::entity>(fixture->GetBody()->GetUserData().pointer));
+        return true;
+    }
+};
+
+int GridCell(float valueWorld, float cellSize)
+{
+    return static_cast<int>(std::floor(valueWorld / cellSize));
+}
+
+uint64_t PackCell(int x, int y)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+} // namespace
+
+CameraCuller::CameraCuller(entt::registry& registry)
+  : registry(registry), gameState(registry.get<GameOptions>(registry.view<GameOptions>().front())),
+    coordinatesTransformer(registry),
+    gridCellSize(utils::GetConfig<float, "RenderWorldSystem.renderOnlyTilesGridCellSize">())
+{
+    registry.on_construct<RenderOnlyTileComponent>().connect<&CameraCuller::OnRenderOnlyTilesChanged>(this);
+    registry.on_destroy<RenderOnlyTileComponent>().connect<&CameraCuller::OnRenderOnlyTilesChanged>(this);
+}
+
+CameraCuller::~CameraCuller()
+{
+    registry.on_construct<RenderOnlyTileComponent>().disconnect(this);
+    registry.on_destroy<RenderOnlyTileComponent>().disconnect(this);
+}
+
+void CameraCuller::Update()
+{
+    const auto& marginWorld = utils::GetConfig<float, "RenderWorldSystem.cullingMarginWorld">();
+    visibleMinWorld = coordinatesTransformer.ScreenToWorld(glm::vec2(0, 0)) - glm::vec2(marginWorld);
+    visibleMaxWorld = coordinatesTransformer.ScreenToWorld(gameState.windowOptions.windowSize) + glm::vec2(marginWorld);
+
+    UpdateVisibleBodies();
+    UpdateVisibleRenderOnlyTiles();
+}
+
+void CameraCuller::UpdateVisibleBodies()
+{
+    visibleBodies.clear();
+    auto physicsWorld = gameState.physicsWorld;
+    if (!physicsWorld)
+        return;
+
+    b2AABB cameraAabb;
+    cameraAabb.lowerBound = coordinatesTransformer.WorldToPhysics(visibleMinWorld);
+    cameraAabb.upperBound = coordinatesTransformer.WorldToPhysics(visibleMaxWorld);
+    CollectBodiesQueryCallback queryCallback(visibleBodies);
+    physicsWorld->QueryAABB(&queryCallback, cameraAabb);
+
+    // Body with several fixtures is reported several times.
+    std::sort(visibleBodies.begin(), visibleBodies.end());
+    visibleBodies.erase(std::unique(visibleBodies.begin(), visibleBodies.end()), visibleBodies.end());
+    auto isInvalid = [this](entt::entity entity)
+    { return !registry.valid(entity) || !registry.all_of<PhysicsComponent>(entity); };
+    visibleBodies.erase(std::remove_if(visibleBodies.begin(), visibleBodies.end(), isInvalid), visibleBodies.end());
+}
+
+void CameraCuller::UpdateVisibleRenderOnlyTiles()
+{
+    if (isRenderOnlyTilesGridDirty)
+        RebuildRenderOnlyTilesGrid();
+
+    visibleRenderOnlyTiles.clear();
+    for (int y = GridCell(visibleMinWorld.y, gridCellSize); y <= GridCell(visibleMaxWorld.y, gridCellSize); ++y)
+    {
+        for (int x = GridCell(visibleMinWorld.x, gridCellSize); x <= GridCell(visibleMaxWorld.x, gridCellSize); ++x)
+        {
+            auto it = renderOnlyTilesByCell.find(PackCell(x, y));
+            if (it == renderOnlyTilesByCell.end())
+                continue;
+
+            for (auto entity : it->second)
+            {
+                const auto& [tileComponent, renderOnlyTile] =
+                    registry.get<TileComponent, RenderOnlyTileComponent>(entity);
+                if (IsVisible(renderOnlyTile.centerWorld, tileComponent.sizeWorld))
+                    visibleRenderOnlyTiles.push_back(entity);
+            }
+        }
+    }
+
+    // Tile covering several cells is found several times.
+    std::sort(visibleRenderOnlyTiles.begin(), visibleRenderOnlyTiles.end());
+    visibleRenderOnlyTiles.erase(
+        std::unique(visibleRenderOnlyTiles.begin(), visibleRenderOnlyTiles.end()), visibleRenderOnlyTiles.end());
+}
+
+void CameraCuller::RebuildRenderOnlyTilesGrid()
+{
+    renderOnlyTilesByCell.clear();
+    auto renderOnlyTilesView = registry.view<TileComponent, RenderOnlyTileComponent>();
+    for (auto entity : renderOnlyTilesView)
+    {
+        const auto& [tileComponent, renderOnlyTile] =
+            renderOnlyTilesView.get<TileComponent, RenderOnlyTileComponent>(entity);
+        const glm::vec2 minWorld = renderOnlyTile.centerWorld - tileComponent.sizeWorld / 2.0f;
+        const glm::vec2 maxWorld = renderOnlyTile.centerWorld + tileComponent.sizeWorld / 2.0f;
+        for (int y = GridCell(minWorld.y, gridCellSize); y <= GridCell(maxWorld.y, gridCellSize); ++y)
+            for (int x = GridCell(minWorld.x, gridCellSize); x <= GridCell(maxWorld.x, gridCellSize); ++x)
+                renderOnlyTilesByCell[PackCell(x, y)].push_back(entity);
+    }
+    isRenderOnlyTilesGridDirty = false;
+}
+bool CameraCuller::IsVisible(const glm::vec2& centerWorld, const glm::vec2& sizeWorld) const
+{
+    const glm::vec2 minWorld = centerWorld - sizeWorld / 2.0f;
+    const glm::vec2 maxWorld = centerWorld + sizeWorld / 2.0f;
+    return maxWorld.x >= visibleMinWorld.x && maxWorld.y >= visibleMinWorld.y && minWorld.x <= visibleMaxWorld.x &&
+        minWorld.y <= visibleMaxWorld.y;
+}
+
+bool CameraCuller::IsVisible(const b2Body* body) const
+{
+    const b2Vec2 minPhysics = coordinatesTransformer.WorldToPhysics(visibleMinWorld);
+    const b2Vec2 maxPhysics = coordinatesTransformer.WorldToPhysics(visibleMaxWorld);
+    for (auto fixture = body->GetFixtureList(); fixture; fixture = fixture->GetNext())
+    {
+        for (int32 childIndex = 0; childIndex < fixture->GetShape()->GetChildCount(); ++childIndex)
+        {
+            const b2AABB& aabb = fixture->GetAABB(childIndex);
+            if (aabb.upperBound.x >= minPhysics.x && aabb.upperBound.y >= minPhysics.y &&
+                aabb.lowerBound.x <= maxPhysics.x && aabb.lowerBound.y <= maxPhysics.y)
+                return true;
+        }
+    }
+    return false;
+}
+
+void CameraCuller::OnRenderOnlyTilesChanged(
+    [[maybe_unused]] entt::registry& changedRegistry, [[maybe_unused]] entt::entity entity)
+{
+    // Tiles are created and destroyed in bulk with the level. Grid is rebuilt once on the next update.
+    isRenderOnlyTilesGridDirty = true;
+}
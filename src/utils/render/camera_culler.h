@@ -0,0 +1,43 @@
+#pragma once
+#include <box2d/box2d.h>
+#include <cstdint>
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+#include <unordered_map>
+#include <utils/coordinates_transformer.h>
+#include <utils/game_options.h>
+#include <vector>
+
+// Finds entities inside the camera rectangle. Box2D broadphase is used as the spatial index of the bodies, so there
+// is no extra structure to keep in sync with the moving objects. Render-only tiles have no bodies and never move.
+// They are indexed by a uniform grid which is rebuilt when such tiles are created or destroyed.
+class CameraCuller
+{
+    entt::registry& registry;
+    GameOptions& gameState;
+    CoordinatesTransformer coordinatesTransformer;
+    glm::vec2 visibleMinWorld{};
+    glm::vec2 visibleMaxWorld{};
+    std::vector<entt::entity> visibleBodies; // Entities of the bodies which fixtures overlap the camera rect.
+    float gridCellSize; // In world pixels.
+    std::unordered_map<uint64_t, std::vector<entt::entity>> renderOnlyTilesByCell; // Tile is in every cell it covers.
+    bool isRenderOnlyTilesGridDirty = true;
+    std::vector<entt::entity> visibleRenderOnlyTiles;
+public:
+    explicit CameraCuller(entt::registry& registry);
+    ~CameraCuller();
+    CameraCuller(const CameraCuller&) = delete;
+    CameraCuller& operator=(const CameraCuller&) = delete;
+    // Should be called once per frame before the rendering. Camera rect is grown by the margin from the config,
+    // because sprites may be bigger than the fixtures.
+    void Update();
+    [[nodiscard]] const std::vector<entt::entity>& GetVisibleBodies() const { return visibleBodies; }
+    [[nodiscard]] const std::vector<entt::entity>& GetVisibleRenderOnlyTiles() const { return visibleRenderOnlyTiles; }
+    [[nodiscard]] bool IsVisible(const glm::vec2& centerWorld, const glm::vec2& sizeWorld) const;
+    [[nodiscard]] bool IsVisible(const b2Body* body) const;
+private:
+    void UpdateVisibleBodies();
+    void UpdateVisibleRenderOnlyTiles();
+    void RebuildRenderOnlyTilesGrid();
+    void OnRenderOnlyTilesChanged(entt::registry& changedRegistry, entt::entity entity);
+};
@@ -0,0 +1,83 @@
+#include "dynamic_resolution.h"
+#include <algorithm>
+#include <my_cpp_utils/config.h>
+#include <utility>
+#include <utils/sdl/sdl_texture_process.h>
+
+DynamicResolution::DynamicResolution(entt::registry& registry, SDL_Renderer* renderer)
+  : renderer(renderer), gameState(registry.get<GameOptions>(registry.view<GameOptions>().front()))
+{}
+
+void DynamicResolution::BeginFrame()
+{
+    if (!utils::GetConfig<bool, "DynamicResolution.enabled">() || !SDL_RenderTargetSupported(renderer))
+    {
+        lastFrameStart.reset();
+        gameState.debugInfo.resolutionScale = 1.0f;
+        return;
+    }
+
+    UpdateResolutionScale();
+
+    const glm::ivec2 windowSize(gameState.windowOptions.windowSize);
+    int textureWidth = 0;
+    int textureHeight = 0;
+    if (targetTexture)
+        SDL_QueryTexture(targetTexture->get(), nullptr, nullptr, &textureWidth, &textureHeight);
+    if (!targetTexture || textureWidth != windowSize.x || textureHeight != windowSize.y)
+    {
+        targetTexture = CreateRenderTargetTexture(renderer, windowSize.x, windowSize.y);
+        SDL_SetTextureBlendMode(targetTexture->get(), SDL_BLENDMODE_NONE);
+        SDL_SetTextureScaleMode(targetTexture->get(), SDL_ScaleModeLinear);
+    }
+
+    // Scale of the renderer is reset by SDL_SetRenderTarget and restored when the window becomes the target again.
+    // So the world is drawn in the window coordinates and lands into the scaled part of the texture.
+    SDL_SetRenderTarget(renderer, targetTexture->get());
+    SDL_RenderSetScale(renderer, resolutionScale, resolutionScale);
+    isRenderingToTarget = true;
+}
+
+void DynamicResolution::EndFrame()
+{
+    if (!isRenderingToTarget)
+        return;
+
+    SDL_SetRenderTarget(renderer, nullptr);
+    isRenderingToTarget = false;
+
+    const glm::vec2& windowSize = gameState.windowOptions.windowSize;
+    const SDL_Rect srcRect = {
+        0, 0, static_cast<int>(windowSize.x * resolutionScale), static_cast<int>(windowSize.y * resolutionScale)};
+    // The blit is not a draw of the world, so it is not counted in the draw calls.
+    SDL_RenderCopy(renderer, targetTexture->get(), &srcRect, nullptr);
+}
+
+void DynamicResolution::UpdateResolutionScale()
+{
+    const auto frameStart = std::chrono::steady_clock::now();
+    const auto previousFrameStart = std::exchange(lastFrameStart, frameStart);
+    if (!previousFrameStart)
+        return;
+
+    // Frame time includes the waiting for vsync and the frame cap, so the GPU load is visible here too.
+    const float frameTimeMs = std::chrono::duration<float, std::milli>(frameStart - *previousFrameStart).count();
+    const float budgetMs = 1000.0f / utils::GetConfig<unsigned, "main.fps">();
+    const auto minScale = utils::GetConfig<float, "DynamicResolution.minScale">();
+    const auto scaleStep = utils::GetConfig<float, "DynamicResolution.scaleStep">();
+    const auto framesBeforeUpscale = utils::GetConfig<size_t, "DynamicResolution.framesBeforeUpscale">();
+
+    // Go down at once, but go up only after a series of good frames. Otherwise the scale would flicker.
+    if (frameTimeMs > budgetMs * utils::GetConfig<float, "DynamicResolution.overBudgetFactor">())
+    {
+        resolutionScale = std::max(resolutionScale - scaleStep, minScale);
+        framesWithinBudget = 0;
+    }
+    else if (++framesWithinBudget >= framesBeforeUpscale)
+    {
+        resolutionScale = std::min(resolutionScale + scaleStep, 1.0f);
+        framesWithinBudget = 0;
+    }
+
+    gameState.debugInfo.resolutionScale = resolutionScale;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <SDL.h>
+#include <chrono>
+#include <entt/entt.hpp>
+#include <memory>
+#include <optional>
+#include <utils/game_options.h>
+#include <utils/sdl/sdl_RAII.h>
+
+// Renders the world into an offscreen texture which resolution follows the frame time, then stretches it to the
+// window. When frames take longer than the budget, fewer pixels are drawn. The resolution is restored step by step
+// once the frame rate holds.
+class DynamicResolution
+{
+    SDL_Renderer* renderer;
+    GameOptions& gameState;
+    std::shared_ptr<SDLTextureRAII> targetTexture; // Window sized. Only the top left part is used at lower scales.
+    std::optional<std::chrono::steady_clock::time_point> lastFrameStart;
+    float resolutionScale = 1.0f;
+    size_t framesWithinBudget = 0;
+    bool isRenderingToTarget = false;
+public:
+    DynamicResolution(entt::registry& registry, SDL_Renderer* renderer);
+    // Start rendering of the world into the offscreen texture. Does nothing if disabled in the config.
+    void BeginFrame();
+    // Stretch the rendered world to the window. HUD and ImGui should be drawn after.
+    void EndFrame();
+private:
+    void UpdateResolutionScale();
+};
@@ -0,0 +1,50 @@
+#include "render_queue.h"
+#include <algorithm>
+#include <functional>
+
+namespace
+{
+
+SDL_Texture* GetTexture(const TilesRenderQueue::Item& item)
+{
+    return item.tile->texturePtr ? item.tile->texturePtr->get() : nullptr;
+}
+
+} // namespace
+
+void TilesRenderQueue::Clear()
+{
+    for (auto& bucket : buckets)
+        bucket.clear();
+}
+
+void TilesRenderQueue::Push(const TileComponent& tile, const glm::vec2& centerWorld, float angle)
+{
+    buckets[magic_enum::enum_index(tile.zOrderingType).value()].push_back({&tile, centerWorld, angle});
+}
+
+void TilesRenderQueue::Sort()
+{
+    auto isLessTexture = [](const Item& lhs, const Item& rhs)
+    { return std::less<SDL_Texture*>()(GetTexture(lhs), GetTexture(rhs)); };
+
+    for (auto& bucket : buckets)
+    {
+        // Levels usually use one tileset, so the bucket is often already grouped.
+        if (!std::is_sorted(bucket.begin(), bucket.end(), isLessTexture))
+            std::stable_sort(bucket.begin(), bucket.end(), isLessTexture);
+    }
+}
+
+const std::vector<TilesRenderQueue::Item>& TilesRenderQueue::GetItems(ZOrderingType zOrderingType) const
+{
+    return buckets[magic_enum::enum_index(zOrderingType).value()];
+}
+
+size_t TilesRenderQueue::GetSize() const
+{
+    size_t size = 0;
+    for (const auto& bucket : buckets)
+        size += bucket.size();
+    return size;
+}
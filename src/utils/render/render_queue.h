@@ -0,0 +1,30 @@
+#pragma once
+#include <SDL.h>
+#include <array>
+#include <ecs/components/rendering_components.h>
+#include <glm/glm.hpp>
+#include <magic_enum.hpp>
+#include <vector>
+
+// Tiles of the frame bucketed by the z-order. Drawables are pushed in one pass and submitted layer by layer. Inside
+// of the layer tiles are grouped by the texture, so the renderer switches textures as rarely as possible.
+// Buckets keep their capacity between the frames.
+class TilesRenderQueue
+{
+public:
+    struct Item
+    {
+        const TileComponent* tile; // Valid until the registry is changed. Queue is rebuilt every frame.
+        glm::vec2 centerWorld;
+        float angle;
+    };
+private:
+    std::array<std::vector<Item>, magic_enum::enum_count<ZOrderingType>()> buckets;
+public:
+    void Clear();
+    void Push(const TileComponent& tile, const glm::vec2& centerWorld, float angle);
+    // Group the items of every layer by the texture. Order of the items with the same texture is kept.
+    void Sort();
+    [[nodiscard]] const std::vector<Item>& GetItems(ZOrderingType zOrderingType) const;
+    [[nodiscard]] size_t GetSize() const;
+};
@@ -0,0 +1,55 @@
+#pragma once
+#include <SDL.h>
+#include <array>
+#include <ecs/components/rendering_components.h>
+#include <glm/glm.hpp>
+#include <magic_enum.hpp>
+#include <memory>
+#include <vector>
+
+// Sprite prepared for drawing. Doesn't reference the registry, so it may be processed by another thread.
+struct SpriteDrawItem
+{
+    SDL_Texture* texture; // Nullptr for the colored quad.
+    SDL_FPoint uvMin; // Texture coordinates are swapped for the flipped sprite.
+    SDL_FPoint uvMax;
+    SDL_Color color;
+    glm::vec2 centerWorld;
+    glm::vec2 sizeWorld;
+    float angle;
+    // Same sprite for SdlPrimitivesRenderer::RenderTile. Used when the sprite batching is disabled.
+    SDL_Rect textureRect;
+    SDL_RendererFlip flip;
+    ColorName colorName;
+};
+
+// Sprites of the frame captured at the end of the simulation tick with the camera state of that tick.
+struct RenderSnapshot
+{
+    // Tiles of every ZOrderingType, then animations. Passes are drawn in order with other layers in between.
+    static constexpr size_t animationsPass = magic_enum::enum_count<ZOrderingType>();
+    static constexpr size_t passesCount = animationsPass + 1;
+
+    std::array<std::vector<SpriteDrawItem>, passesCount> passes;
+    // Textures of the items. Entities may be destroyed before the snapshot is drawn.
+    std::vector<std::shared_ptr<SDLTextureRAII>> textures;
+    glm::vec2 cameraCenterSdl{};
+    float cameraScale{1.0f};
+    glm::vec2 windowSize{};
+    bool isSpriteBatching{false}; // Geometry is built only for the batched snapshot.
+};
+
+// Screen space geometry built from the snapshot. Every batch is one SDL_RenderGeometry call.
+struct SpriteGeometry
+{
+    struct Batch
+    {
+        SDL_Texture* texture;
+        int firstIndex;
+        int indicesCount;
+    };
+
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+    std::array<std::vector<Batch>, RenderSnapshot::passesCount> batches;
+};
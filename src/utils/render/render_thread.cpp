@@ -0,0 +1,117 @@
+#include "render_thread.h"
+#include <my_cpp_utils/config.h>
+#include <utility>
+#include <utils/render/sprite_batcher.h>
+
+RenderThread::RenderThread()
+{
+#ifndef __EMSCRIPTEN__
+    if (utils::GetConfig<bool, "RenderWorldSystem.renderThread">())
+        worker = std::thread(&RenderThread::WorkerLoop, this);
+#endif // __EMSCRIPTEN__
+}
+
+RenderThread::~RenderThread()
+{
+    if (!worker.joinable())
+        return;
+
+    {
+        std::lock_guard lock(mutex);
+        isStopping = true;
+    }
+    condition.notify_all();
+    worker.join();
+}
+
+void RenderThread::Publish()
+{
+    const RenderSnapshot& snapshot = snapshots[writeIndex];
+    writeIndex = 1 - writeIndex;
+    isPublished = true;
+
+    if (!worker.joinable())
+    {
+        BuildGeometry(snapshot, geometry);
+        return;
+    }
+
+    {
+        std::unique_lock lock(mutex);
+        // Geometry of the previous snapshot may still be built if it was never waited for.
+        condition.wait(lock, [this] { return isGeometryReady; });
+        pendingSnapshot = &snapshot;
+        isGeometryReady = false;
+    }
+    condition.notify_all();
+}
+
+const RenderSnapshot* RenderThread::GetPublishedSnapshot() const
+{
+    return isPublished ? &snapshots[1 - writeIndex] : nullptr;
+}
+
+const SpriteGeometry& RenderThread::WaitForGeometry()
+{
+    if (worker.joinable())
+    {
+        std::unique_lock lock(mutex);
+        condition.wait(lock, [this] { return isGeometryReady; });
+    }
+    return geometry;
+}
+
+void RenderThread::WorkerLoop()
+{
+    while (true)
+    {
+        const RenderSnapshot* snapshot = nullptr;
+        {
+            std::unique_lock lock(mutex);
+            condition.wait(lock, [this] { return isStopping || pendingSnapshot; });
+            if (isStopping)
+                return;
+            snapshot = std::exchange(pendingSnapshot, nullptr);
+        }
+
+        BuildGeometry(*snapshot, geometry);
+
+        {
+            std::lock_guard lock(mutex);
+            isGeometryReady = true;
+        }
+        condition.notify_all();
+    }
+}
+
+void RenderThread::BuildGeometry(const RenderSnapshot& snapshot, SpriteGeometry& geometry)
+{
+    geometry.vertices.clear();
+    geometry.indices.clear();
+    for (auto& batches : geometry.batches)
+        batches.clear();
+
+    // Sprites of the not batched snapshot are drawn one by one with SdlPrimitivesRenderer.
+    if (!snapshot.isSpriteBatching)
+        return;
+
+    for (size_t pass = 0; pass < RenderSnapshot::passesCount; ++pass)
+    {
+        auto& batches = geometry.batches[pass];
+        for (const auto& item : snapshot.passes[pass])
+        {
+            // Sprites of one texture in a row share the batch.
+            if (batches.empty() || batches.back().texture != item.texture)
+                batches.push_back({item.texture, static_cast<int>(geometry.indices.size()), 0});
+
+            // Same transform as CoordinatesTransformer::WorldToScreen with the camera of the snapshot.
+            const glm::vec2 centerScreen =
+                (item.centerWorld - snapshot.cameraCenterSdl) * snapshot.cameraScale + snapshot.windowSize / 2.0f;
+            const glm::vec2 sizeScreen = item.sizeWorld * snapshot.cameraScale;
+            AppendSpriteQuad(
+                geometry.vertices, geometry.indices, item.uvMin, item.uvMax, centerScreen, sizeScreen, item.angle,
+                item.color);
+            batches.back().indicesCount += 6;
+        }
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utils/render/render_snapshot.h>
+
+// Double-buffered hand-off of the render snapshots to the worker thread. The snapshot of the tick N is published at
+// the end of the tick. The worker turns its sprites into batches of screen space geometry while the main thread
+// simulates the tick N + 1, then the main thread draws it. SDL_Renderer must be used from the thread which created
+// it, so the batches are submitted by the main thread.
+class RenderThread
+{
+    std::array<RenderSnapshot, 2> snapshots;
+    size_t writeIndex = 0; // Snapshot filled by the main thread. The other one is the published one.
+    bool isPublished = false; // Nothing to draw before the first publish.
+    SpriteGeometry geometry;
+    const RenderSnapshot* pendingSnapshot = nullptr;
+    bool isGeometryReady = true;
+    bool isStopping = false;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::thread worker; // Not started if the thread is disabled. Geometry is built on publish then.
+public:
+    RenderThread();
+    ~RenderThread();
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+    // Snapshot to fill. Valid until the next publish.
+    [[nodiscard]] RenderSnapshot& GetSnapshotToWrite() { return snapshots[writeIndex]; }
+    // Hand the filled snapshot to the worker. Geometry of the previous snapshot should not be used after this call.
+    void Publish();
+    // Snapshot of the last publish. Read only: the worker reads it too. Nullptr before the first publish.
+    [[nodiscard]] const RenderSnapshot* GetPublishedSnapshot() const;
+    // Block until the geometry of the last published snapshot is built.
+    const SpriteGeometry& WaitForGeometry();
+private:
+    void WorkerLoop();
+    static void BuildGeometry(const RenderSnapshot& snapshot, SpriteGeometry& geometry);
+};
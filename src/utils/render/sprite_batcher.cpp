@@ -0,0 +1,79 @@
+#include "sprite_batcher.h"
+#include <cmath>
+#include <utility>
+
+void AppendSpriteQuad(
+    std::vector<SDL_Vertex>& vertices, std::vector<int>& indices, const SDL_FPoint& uvMin, const SDL_FPoint& uvMax,
+    const glm::vec2& centerScreen, const glm::vec2& sizeScreen, float angle, const SDL_Color& color)
+{
+    // Corners in the order: top left, top right, bottom right, bottom left.
+    const glm::vec2 halfSize = sizeScreen / 2.0f;
+    glm::vec2 corners[4] = {{-halfSize.x, -halfSize.y}, {halfSize.x, -halfSize.y}, {halfSize.x, halfSize.y},
+                            {-halfSize.x, halfSize.y}};
+    if (angle != 0.0f)
+    {
+        const float cosAngle = std::cos(angle);
+        const float sinAngle = std::sin(angle);
+        for (auto& corner : corners)
+            corner = {corner.x * cosAngle - corner.y * sinAngle, corner.x * sinAngle + corner.y * cosAngle};
+    }
+
+    const SDL_FPoint texCoords[4] = {{uvMin.x, uvMin.y}, {uvMax.x, uvMin.y}, {uvMax.x, uvMax.y}, {uvMin.x, uvMax.y}};
+    const int firstVertex = static_cast<int>(vertices.size());
+    for (int i = 0; i < 4; ++i)
+    {
+        const glm::vec2 position = centerScreen + corners[i];
+        vertices.push_back({{position.x, position.y}, color, texCoords[i]});
+    }
+    for (int offset : {0, 1, 2, 2, 3, 0})
+        indices.push_back(firstVertex + offset);
+}
+
+SpriteBatcher::SpriteBatcher(SDL_Renderer* renderer) : renderer(renderer)
+{}
+
+void SpriteBatcher::Draw(
+    SDL_Texture* texture, const SDL_Rect& srcRect, const glm::vec2& centerScreen, const glm::vec2& sizeScreen,
+    float angle, SDL_RendererFlip flip)
+{
+    if (texture != batchTexture)
+    {
+        Flush();
+
+        int textureWidth = 0;
+        int textureHeight = 0;
+        if (SDL_QueryTexture(texture, nullptr, nullptr, &textureWidth, &textureHeight) != 0)
+            return;
+
+        batchTexture = texture;
+        batchTextureSize = glm::vec2(textureWidth, textureHeight);
+    }
+
+    float u0 = srcRect.x / batchTextureSize.x;
+    float v0 = srcRect.y / batchTextureSize.y;
+    float u1 = (srcRect.x + srcRect.w) / batchTextureSize.x;
+    float v1 = (srcRect.y + srcRect.h) / batchTextureSize.y;
+    if (flip & SDL_FLIP_HORIZONTAL)
+        std::swap(u0, u1);
+    if (flip & SDL_FLIP_VERTICAL)
+        std::swap(v0, v1);
+
+    const SDL_Color white = {255, 255, 255, 255};
+    AppendSpriteQuad(vertices, indices, {u0, v0}, {u1, v1}, centerScreen, sizeScreen, angle, white);
+}
+
+bool SpriteBatcher::Flush()
+{
+    const bool hasQuads = !vertices.empty();
+    if (hasQuads)
+    {
+        SDL_RenderGeometry(
+            renderer, batchTexture, vertices.data(), static_cast<int>(vertices.size()), indices.data(),
+            static_cast<int>(indices.size()));
+    }
+
+    vertices.clear();
+    indices.clear();
+    batchTexture = nullptr;
+    return hasQuads;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <SDL.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+// Append two triangles of the quad. Texture coordinates of the corners are taken from the min/max, so the flipped
+// sprite is made by swapping them. Angle in radians, clockwise on the screen. Rotation is around the center.
+void AppendSpriteQuad(
+    std::vector<SDL_Vertex>& vertices, std::vector<int>& indices, const SDL_FPoint& uvMin, const SDL_FPoint& uvMax,
+    const glm::vec2& centerScreen, const glm::vec2& sizeScreen, float angle, const SDL_Color& color);
+
+// Accumulates textured quads into one vertex array and submits them with SDL_RenderGeometry. The batch is flushed
+// when the texture changes, so the drawing order is kept. Sprites sorted by the texture cost one draw call per texture.
+class SpriteBatcher
+{
+    SDL_Renderer* renderer;
+    SDL_Texture* batchTexture = nullptr;
+    glm::vec2 batchTextureSize{};
+    std::vector<SDL_Vertex> vertices; // Reused between the batches.
+    std::vector<int> indices;
+public:
+    explicit SpriteBatcher(SDL_Renderer* renderer);
+    // Angle in radians, clockwise on the screen like in SDL_RenderCopyEx. Rotation is around the center.
+    void Draw(
+        SDL_Texture* texture, const SDL_Rect& srcRect, const glm::vec2& centerScreen, const glm::vec2& sizeScreen,
+        float angle, SDL_RendererFlip flip);
+    // Submit the accumulated quads. Should be called before anything is drawn around the batcher.
+    // Return true if the draw call was made.
+    bool Flush();
+};
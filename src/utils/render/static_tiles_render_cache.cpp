@@ -0,0 +1,274 @@
+#include "static_tiles_render_cache.h"
+#include <cmath>
+#include <ecs/components/physics_components.h>
+#include <my_cpp_utils/config.h>
+#include <numbers>
+#include <utils/logger.h>
+#include <utils/sdl/sdl_colors.h>
+#include <utils/sdl/sdl_texture_process.h>
+
+namespace
+{
+
+uint64_t PackChunk(const glm::ivec2& chunkPos)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(chunkPos.x)) << 32) | static_cast<uint32_t>(chunkPos.y);
+}
+
+glm::ivec2 UnpackChunk(uint64_t key)
+{
+    return {static_cast<int32_t>(key >> 32), static_cast<int32_t>(key & 0xFFFFFFFF)};
+}
+
+} // namespace
+
+StaticTilesRenderCache::StaticTilesRenderCache(entt::registry& registry, SDL_Renderer* renderer)
+  : registry(registry), renderer(renderer), gameState(registry.get<GameOptions>(registry.view<GameOptions>().front())),
+    coordinatesTransformer(registry), chunkSize(utils::GetConfig<int, "RenderWorldSystem.staticTilesChunkSize">())
+{
+    registry.on_construct<TileComponent>().connect<&StaticTilesRenderCache::OnEntityConstructed>(this);
+    registry.on_construct<PhysicsComponent>().connect<&StaticTilesRenderCache::OnEntityConstructed>(this);
+    registry.on_construct<RenderOnlyTileComponent>().connect<&StaticTilesRenderCache::OnEntityConstructed>(this);
+    registry.on_destroy<TileComponent>().connect<&StaticTilesRenderCache::OnTileRemoved>(this);
+    registry.on_destroy<PhysicsComponent>().connect<&StaticTilesRenderCache::OnTileRemoved>(this);
+    registry.on_update<PhysicsComponent>().connect<&StaticTilesRenderCache::OnBodyChanged>(this);
+}
+
+StaticTilesRenderCache::~StaticTilesRenderCache()
+{
+    registry.on_construct<TileComponent>().disconnect(this);
+    registry.on_construct<PhysicsComponent>().disconnect(this);
+    registry.on_construct<RenderOnlyTileComponent>().disconnect(this);
+    registry.on_destroy<TileComponent>().disconnect(this);
+    registry.on_destroy<PhysicsComponent>().disconnect(this);
+    registry.on_update<PhysicsComponent>().disconnect(this);
+}
+
+void StaticTilesRenderCache::Update()
+{
+    // Tiles are baked again from scratch when the cache is enabled.
+    if (!utils::GetConfig<bool, "RenderWorldSystem.staticTilesCache">())
+    {
+        cacheOwner.reset();
+        Clear();
+        return;
+    }
+
+    // Tiles of the previous level are destroyed with the Box2D world. Textures are released too.
+    if (cacheOwner.lock() != gameState.physicsWorld)
+    {
+        cacheOwner = gameState.physicsWorld;
+        Clear();
+        for (auto entity : registry.view<TileComponent>())
+            BakeTile(entity);
+    }
+
+    for (auto entity : constructedEntities)
+        BakeTile(entity);
+    constructedEntities.clear();
+
+    size_t rebuiltChunks = 0;
+    for (auto& chunks : chunksByZOrder)
+    {
+        for (auto it = chunks.begin(); it != chunks.end();)
+        {
+            auto& chunk = it->second;
+            if (chunk.tiles.empty())
+            {
+                it = chunks.erase(it);
+                continue;
+            }
+
+            if (chunk.isDirty)
+            {
+                RebuildChunk(UnpackChunk(it->first), chunk);
+                rebuiltChunks++;
+            }
+            ++it;
+        }
+    }
+
+    if (rebuiltChunks > 0)
+        MY_LOG(debug, "[StaticTilesRenderCache] Rebuilt {} chunks", rebuiltChunks);
+}
+
+void StaticTilesRenderCache::Render(ZOrderingType zOrderingType)
+{
+    const auto& chunks = chunksByZOrder[magic_enum::enum_index(zOrderingType).value()];
+    if (chunks.empty())
+        return;
+
+    // Chunks covered by the window.
+    const auto& windowSize = gameState.windowOptions.windowSize;
+    const glm::vec2 windowMinWorld = coordinatesTransformer.ScreenToWorld(glm::vec2(0, 0));
+    const glm::vec2 windowMaxWorld = coordinatesTransformer.ScreenToWorld(windowSize);
+    const glm::ivec2 minChunk(
+        static_cast<int>(std::floor(windowMinWorld.x / chunkSize)),
+        static_cast<int>(std::floor(windowMinWorld.y / chunkSize)));
+    const glm::ivec2 maxChunk(
+        static_cast<int>(std::floor(windowMaxWorld.x / chunkSize)),
+        static_cast<int>(std::floor(windowMaxWorld.y / chunkSize)));
+    const float chunkSizeScreen = coordinatesTransformer.WorldToScreen(static_cast<float>(chunkSize));
+
+    for (int y = minChunk.y; y <= maxChunk.y; ++y)
+    {
+        for (int x = minChunk.x; x <= maxChunk.x; ++x)
+        {
+            auto it = chunks.find(PackChunk({x, y}));
+            if (it == chunks.end() || !it->second.texture)
+                continue;
+
+            const glm::vec2 chunkTopLeftScreen =
+                coordinatesTransformer.WorldToScreen(glm::vec2(x * chunkSize, y * chunkSize));
+            SDL_FRect destRect{chunkTopLeftScreen.x, chunkTopLeftScreen.y, chunkSizeScreen, chunkSizeScreen};
+            SDL_RenderCopyF(renderer, it->second.texture->get(), nullptr, &destRect);
+            gameState.debugInfo.drawCalls++;
+        }
+    }
+}
+
+bool StaticTilesRenderCache::IsStaticTile(entt::entity entity) const
+{
+    if (!registry.all_of<TileComponent>(entity))
+        return false;
+
+    if (registry.all_of<RenderOnlyTileComponent>(entity))
+        return true;
+
+    auto physicsComponent = registry.try_get<PhysicsComponent>(entity);
+    return physicsComponent && physicsComponent->bodyRAII->GetBody()->GetType() == b2_staticBody;
+}
+
+void StaticTilesRenderCache::InvalidateAllChunks(bool areTexturesLost)
+{
+    for (auto& chunks : chunksByZOrder)
+    {
+        for (auto& [_, chunk] : chunks)
+        {
+            chunk.isDirty = true;
+            if (areTexturesLost)
+                chunk.texture.reset();
+        }
+    }
+}
+
+void StaticTilesRenderCache::Clear()
+{
+    for (auto& chunks : chunksByZOrder)
+        chunks.clear();
+    bakedTiles.clear();
+    constructedEntities.clear();
+}
+
+void StaticTilesRenderCache::BakeTile(entt::entity entity)
+{
+    if (!registry.valid(entity) || bakedTiles.contains(entity) || !IsStaticTile(entity))
+        return;
+
+    const auto& tileComponent = registry.get<TileComponent>(entity);
+    float angle = 0.0f;
+    const glm::vec2 centerWorld = GetTileCenterWorld(entity, angle);
+
+    // Rotated tile is covered by the circle around it.
+    const glm::vec2 halfSizeWorld = glm::vec2(glm::length(tileComponent.sizeWorld) / 2.0f);
+    const glm::vec2 minWorld = centerWorld - halfSizeWorld;
+    const glm::vec2 maxWorld = centerWorld + halfSizeWorld;
+
+    auto& bakedTile = bakedTiles[entity];
+    bakedTile.zOrderingType = tileComponent.zOrderingType;
+    auto& chunks = chunksByZOrder[magic_enum::enum_index(tileComponent.zOrderingType).value()];
+    for (int y = static_cast<int>(std::floor(minWorld.y / chunkSize));
+         y <= static_cast<int>(std::floor(maxWorld.y / chunkSize)); ++y)
+    {
+        for (int x = static_cast<int>(std::floor(minWorld.x / chunkSize));
+             x <= static_cast<int>(std::floor(maxWorld.x / chunkSize)); ++x)
+        {
+            const uint64_t key = PackChunk({x, y});
+            auto& chunk = chunks[key];
+            chunk.tiles.insert(entity);
+            chunk.isDirty = true;
+            bakedTile.chunkKeys.push_back(key);
+        }
+    }
+}
+
+void StaticTilesRenderCache::RebuildChunk(const glm::ivec2& chunkPos, Chunk& chunk)
+{
+    if (!chunk.texture)
+        chunk.texture = CreateRenderTargetTexture(renderer, chunkSize, chunkSize);
+
+    SDL_SetRenderTarget(renderer, chunk.texture->get());
+    SetRenderDrawColor(renderer, GetSDLColor(ColorName::Black, 0));
+    SDL_RenderClear(renderer);
+
+    // Tiles are rendered 1:1 in the world pixels. The camera transform is applied when the chunk is drawn.
+    const glm::vec2 chunkTopLeftWorld = glm::vec2(chunkPos) * static_cast<float>(chunkSize);
+    for (auto entity : chunk.tiles)
+    {
+        const auto& tileComponent = registry.get<TileComponent>(entity);
+        float angle = 0.0f;
+        const glm::vec2 centerInChunk = GetTileCenterWorld(entity, angle) - chunkTopLeftWorld;
+        const SDL_FRect destRect{
+            centerInChunk.x - tileComponent.sizeWorld.x / 2.0f, centerInChunk.y - tileComponent.sizeWorld.y / 2.0f,
+            tileComponent.sizeWorld.x, tileComponent.sizeWorld.y};
+
+        if (!tileComponent.texturePtr)
+        {
+            SetRenderDrawColor(renderer, tileComponent.colorName);
+            SDL_RenderFillRectF(renderer, &destRect);
+            continue;
+        }
+
+        const double angleDegrees = angle * 180.0 / std::numbers::pi;
+        SDL_RenderCopyExF(
+            renderer, tileComponent.texturePtr->get(), &tileComponent.textureRect, &destRect, angleDegrees, nullptr,
+            SDL_FLIP_NONE);
+    }
+
+    SDL_SetRenderTarget(renderer, nullptr);
+    chunk.isDirty = false;
+}
+
+glm::vec2 StaticTilesRenderCache::GetTileCenterWorld(entt::entity entity, float& angle) const
+{
+    if (auto renderOnlyTile = registry.try_get<RenderOnlyTileComponent>(entity))
+    {
+        angle = 0.0f;
+        return renderOnlyTile->centerWorld;
+    }
+
+    auto body = registry.get<PhysicsComponent>(entity).bodyRAII->GetBody();
+    angle = body->GetAngle();
+    return coordinatesTransformer.PhysicsToWorld(body->GetPosition());
+}
+
+void StaticTilesRenderCache::OnEntityConstructed([[maybe_unused]] entt::registry& changedRegistry, entt::entity entity)
+{
+    // Components of the tile are emplaced one by one. So the tile is checked on the next update.
+    constructedEntities.push_back(entity);
+}
+
+void StaticTilesRenderCache::OnTileRemoved([[maybe_unused]] entt::registry& changedRegistry, entt::entity entity)
+{
+    auto it = bakedTiles.find(entity);
+    if (it == bakedTiles.end())
+        return;
+
+    auto& chunks = chunksByZOrder[magic_enum::enum_index(it->second.zOrderingType).value()];
+    for (uint64_t key : it->second.chunkKeys)
+    {
+        auto chunkIt = chunks.find(key);
+        if (chunkIt == chunks.end())
+            continue;
+
+        chunkIt->second.tiles.erase(entity);
+        chunkIt->second.isDirty = true;
+    }
+    bakedTiles.erase(it);
+}
+
+void StaticTilesRenderCache::OnBodyChanged(entt::registry& changedRegistry, entt::entity entity)
+{
+    OnTileRemoved(changedRegistry, entity);
+    constructedEntities.push_back(entity);
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <SDL.h>
+#include <array>
+#include <cstdint>
+#include <ecs/components/rendering_components.h>
+#include <entt/entt.hpp>
+#include <magic_enum.hpp>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <utils/coordinates_transformer.h>
+#include <utils/game_options.h>
+#include <utils/sdl/sdl_RAII.h>
+#include <vector>
+
+// Tiles which never move are prerendered into square chunk textures. One quad is drawn per visible chunk instead of
+// one copy per tile. Static tiles are render-only tiles and tiles with static Box2D bodies. Chunks are re-rendered
+// only when their tiles are created, destroyed or change the body type. Changes are tracked by the EnTT signals:
+// the body type change is reported by Box2dBodyTuner with on_update<PhysicsComponent>.
+class StaticTilesRenderCache
+{
+    struct Chunk
+    {
+        std::shared_ptr<SDLTextureRAII> texture; // Render target. Created on the first rebuild.
+        std::unordered_set<entt::entity> tiles; // Tiles which overlap the chunk.
+        bool isDirty = true;
+    };
+
+    // Chunks covered by the baked tile. Kept to invalidate them when the tile is removed.
+    struct BakedTile
+    {
+        ZOrderingType zOrderingType;
+        std::vector<uint64_t> chunkKeys;
+    };
+
+    entt::registry& registry;
+    SDL_Renderer* renderer;
+    GameOptions& gameState;
+    CoordinatesTransformer coordinatesTransformer;
+    int chunkSize; // In world pixels.
+    std::weak_ptr<b2World> cacheOwner; // Physics world of the level whose tiles are baked.
+    std::array<std::unordered_map<uint64_t, Chunk>, magic_enum::enum_count<ZOrderingType>()> chunksByZOrder;
+    std::unordered_map<entt::entity, BakedTile> bakedTiles;
+    std::vector<entt::entity> constructedEntities; // Baked on the next update if they are static tiles.
+public:
+    StaticTilesRenderCache(entt::registry& registry, SDL_Renderer* renderer);
+    ~StaticTilesRenderCache();
+    StaticTilesRenderCache(const StaticTilesRenderCache&) = delete;
+    StaticTilesRenderCache& operator=(const StaticTilesRenderCache&) = delete;
+    // Re-render dirty chunks. Changes the render target, so should be called before the frame rendering starts.
+    // Releases everything if the cache is disabled in the config.
+    void Update();
+    // Draw the visible chunks of the layer.
+    void Render(ZOrderingType zOrderingType);
+    // Return true if the tile is drawn by the cache. Dynamic tiles are drawn as usual.
+    [[nodiscard]] bool IsStaticTile(entt::entity entity) const;
+    [[nodiscard]] size_t GetBakedTilesCount() const { return bakedTiles.size(); }
+    // Every chunk is re-rendered on the next update. Call on SDL_RENDER_TARGETS_RESET: the pixels of the render
+    // targets are lost. On SDL_RENDER_DEVICE_RESET the textures themselves are lost, so they are recreated too.
+    void InvalidateAllChunks(bool areTexturesLost);
+private:
+    void Clear();
+    void BakeTile(entt::entity entity);
+    void RebuildChunk(const glm::ivec2& chunkPos, Chunk& chunk);
+    [[nodiscard]] glm::vec2 GetTileCenterWorld(entt::entity entity, float& angle) const;
+    void OnEntityConstructed(entt::registry& changedRegistry, entt::entity entity);
+    // Tile is destroyed. Its chunks are re-rendered without it.
+    void OnTileRemoved(entt::registry& changedRegistry, entt::entity entity);
+    // Body type is changed. Tile is removed from its chunks and baked again on the next update if it is still static.
+    void OnBodyChanged(entt::registry& changedRegistry, entt::entity entity);
+};
@@ -0,0 +1,145 @@
+#include "asset_loader.h"
+#include <my_cpp_utils/config.h>
+#include <utils/logger.h>
+#include <utils/sdl/sdl_texture_process.h>
+
+namespace
+{
+
+std::shared_ptr<SDLSurfaceRAII> LoadSurface(const std::filesystem::path& absolutePath)
+{
+    return details::LoadSurfaceWithStreamingAccess(absolutePath);
+}
+
+std::shared_ptr<SoundEffectRAII> LoadSoundEffect(const std::filesystem::path& absolutePath)
+{
+    return std::make_shared<SoundEffectRAII>(absolutePath.string());
+}
+
+} // namespace
+
+AssetLoader::AssetLoader()
+{
+#ifndef __EMSCRIPTEN__
+    auto workersCount = utils::GetConfig<size_t, "AssetLoader.workerThreads">();
+    for (size_t i = 0; i < workersCount; ++i)
+        workers.emplace_back(&AssetLoader::WorkerLoop, this);
+#endif // __EMSCRIPTEN__
+}
+
+AssetLoader::~AssetLoader()
+{
+    if (workers.empty())
+        return;
+
+    {
+        std::lock_guard lock(mutex);
+        isStopping = true;
+    }
+    condition.notify_all();
+    for (auto& worker : workers)
+        worker.join();
+}
+
+void AssetLoader::RequestSurface(const std::filesystem::path& absolutePath)
+{
+    Request(surfaces, absolutePath, &LoadSurface);
+}
+
+void AssetLoader::RequestSoundEffect(const std::filesystem::path& absolutePath)
+{
+    Request(soundEffects, absolutePath, &LoadSoundEffect);
+}
+
+std::shared_ptr<SDLSurfaceRAII> AssetLoader::TakeSurface(const std::filesystem::path& absolutePath)
+{
+    return Take(surfaces, absolutePath, &LoadSurface);
+}
+
+std::shared_ptr<SoundEffectRAII> AssetLoader::TakeSoundEffect(const std::filesystem::path& absolutePath)
+{
+    return Take(soundEffects, absolutePath, &LoadSoundEffect);
+}
+
+std::vector<std::pair<std::filesystem::path, std::shared_ptr<SDLSurfaceRAII>>> AssetLoader::TakeReadySurfaces()
+{
+    return TakeReady(surfaces);
+}
+
+std::vector<std::pair<std::filesystem::path, std::shared_ptr<SoundEffectRAII>>> AssetLoader::TakeReadySoundEffects()
+{
+    return TakeReady(soundEffects);
+}
+
+template <typename T>
+void AssetLoader::Request(
+    std::unordered_map<std::filesystem::path, std::future<T>>& requests, const std::filesystem::path& absolutePath,
+    T (*load)(const std::filesystem::path&))
+{
+    if (workers.empty() || requests.contains(absolutePath))
+        return;
+
+    MY_LOG(debug, "Request asset: {}", absolutePath.string());
+    std::packaged_task<T()> loadTask([load, absolutePath] { return load(absolutePath); });
+    requests[absolutePath] = loadTask.get_future();
+
+    {
+        std::lock_guard lock(mutex);
+        tasks.emplace_back([loadTask = std::move(loadTask)]() mutable { loadTask(); });
+    }
+    condition.notify_one();
+}
+
+template <typename T>
+T AssetLoader::Take(
+    std::unordered_map<std::filesystem::path, std::future<T>>& requests, const std::filesystem::path& absolutePath,
+    T (*load)(const std::filesystem::path&))
+{
+    auto requestIt = requests.find(absolutePath);
+    if (requestIt == requests.end())
+        return load(absolutePath);
+
+    auto future = std::move(requestIt->second);
+    requests.erase(requestIt);
+    return future.get();
+}
+
+template <typename T>
+std::vector<std::pair<std::filesystem::path, T>> AssetLoader::TakeReady(
+    std::unordered_map<std::filesystem::path, std::future<T>>& requests)
+{
+    std::vector<std::pair<std::filesystem::path, T>> readyAssets;
+    for (auto requestIt = requests.begin(); requestIt != requests.end();)
+    {
+        if (requestIt->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            ++requestIt;
+            continue;
+        }
+
+        const std::filesystem::path absolutePath = requestIt->first;
+        auto future = std::move(requestIt->second);
+        requestIt = requests.erase(requestIt);
+        readyAssets.emplace_back(absolutePath, future.get());
+    }
+    return readyAssets;
+}
+
+void AssetLoader::WorkerLoop()
+{
+    while (true)
+    {
+        std::packaged_task<void()> task;
+        {
+            std::unique_lock lock(mutex);
+            condition.wait(lock, [this] { return isStopping || !tasks.empty(); });
+            if (isStopping)
+                return;
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+
+        // Exceptions of the task are stored in its future.
+        task();
+    }
+}
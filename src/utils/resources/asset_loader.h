@@ -0,0 +1,58 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <utils/sdl/sdl_RAII.h>
+#include <utils/sdl/sdl_audio_RAII.h>
+#include <vector>
+
+// Decodes images and sounds on a pool of worker threads. Assets are requested as soon as their paths are known and
+// taken when they are needed. Only the CPU side is prepared here: SDL_Renderer must be used from the thread which
+// created it, so textures are created from the decoded surfaces by the caller.
+class AssetLoader
+{
+    std::deque<std::packaged_task<void()>> tasks;
+    bool isStopping = false;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<std::thread> workers; // Empty if the loader is disabled. Assets are decoded on take then.
+
+    // Requested assets by absolute paths. Used by the owner thread only.
+    std::unordered_map<std::filesystem::path, std::future<std::shared_ptr<SDLSurfaceRAII>>> surfaces;
+    std::unordered_map<std::filesystem::path, std::future<std::shared_ptr<SoundEffectRAII>>> soundEffects;
+public:
+    AssetLoader();
+    ~AssetLoader();
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+    // Start decoding of the image into the SDL_PIXELFORMAT_ABGR8888 surface.
+    void RequestSurface(const std::filesystem::path& absolutePath);
+    void RequestSoundEffect(const std::filesystem::path& absolutePath);
+    // Block until the asset is decoded. Not requested asset is decoded on the calling thread.
+    // Errors of the decoding are rethrown here.
+    std::shared_ptr<SDLSurfaceRAII> TakeSurface(const std::filesystem::path& absolutePath);
+    std::shared_ptr<SoundEffectRAII> TakeSoundEffect(const std::filesystem::path& absolutePath);
+    // Decoded assets which were not taken yet, without blocking. Errors of the decoding are rethrown here.
+    std::vector<std::pair<std::filesystem::path, std::shared_ptr<SDLSurfaceRAII>>> TakeReadySurfaces();
+    std::vector<std::pair<std::filesystem::path, std::shared_ptr<SoundEffectRAII>>> TakeReadySoundEffects();
+private:
+    template <typename T>
+    void Request(
+        std::unordered_map<std::filesystem::path, std::future<T>>& requests, const std::filesystem::path& absolutePath,
+        T (*load)(const std::filesystem::path&));
+    template <typename T>
+    T Take(
+        std::unordered_map<std::filesystem::path, std::future<T>>& requests, const std::filesystem::path& absolutePath,
+        T (*load)(const std::filesystem::path&));
+    template <typename T>
+    std::vector<std::pair<std::filesystem::path, T>> TakeReady(
+        std::unordered_map<std::filesystem::path, std::future<T>>& requests);
+    void WorkerLoop();
+};
@@ -1,5 +1,9 @@
 #include "resource_cache.h"
+#include <SDL_mixer.h>
+#include <algorithm>
 #include <filesystem>
+#include <functional>
+#include <my_cpp_utils/config.h>
 #include <utils/logger.h>
 #include <utils/sdl/sdl_RAII.h>
 #include <utils/sdl/sdl_colors.h>
@@ -30,9 +34,56 @@ SDLTextureRAII GetColoredPixelTexture(SDL_Renderer* renderer, const ColorName& c
     return GetColoredPixelTexture(renderer, GetSDLColor(color));
 }
 
+size_t GetTextureBytes(SDL_Texture* texture)
+{
+    Uint32 format = 0;
+    int width = 0;
+    int height = 0;
+    SDL_QueryTexture(texture, &format, nullptr, &width, &height);
+    return static_cast<size_t>(width) * height * SDL_BYTESPERPIXEL(format);
+}
+
+size_t GetSurfaceBytes(SDL_Surface* surface)
+{
+    return static_cast<size_t>(surface->pitch) * surface->h;
+}
+
+// Mix_FreeChunk stops the channels playing the chunk, so such sounds are not evicted.
+bool IsSoundEffectPlaying(Mix_Chunk* chunk)
+{
+    const int channelsCount = Mix_AllocateChannels(-1);
+    for (int channel = 0; channel < channelsCount; ++channel)
+    {
+        if (Mix_Playing(channel) && Mix_GetChunk(channel) == chunk)
+            return true;
+    }
+    return false;
+}
+
 } // namespace
 
-ResourceCache::ResourceCache(SDL_Renderer* renderer) : renderer(renderer)
+size_t EvictLeastRecentlyUsed(std::vector<EvictionCandidate> candidates, size_t& usedBytes, size_t budgetBytes)
+{
+    std::sort(
+        candidates.begin(), candidates.end(),
+        [](const EvictionCandidate& lhs, const EvictionCandidate& rhs) { return lhs.lastUse < rhs.lastUse; });
+
+    size_t evictedEntriesCount = 0;
+    for (auto& candidate : candidates)
+    {
+        if (usedBytes <= budgetBytes)
+            break;
+
+        candidate.evict();
+        usedBytes -= candidate.bytes;
+        evictedEntriesCount++;
+    }
+    return evictedEntriesCount;
+}
+
+ResourceCache::ResourceCache(SDL_Renderer* renderer)
+  : renderer(renderer), atlas(renderer),
+    budgetBytes(utils::GetConfig<size_t, "ResourceCache.budgetMegabytes">() * 1024 * 1024)
 {}
 
 std::shared_ptr<SDLTextureRAII> ResourceCache::LoadTexture(const std::filesystem::path& filePath)
@@ -41,15 +92,16 @@ std::shared_ptr<SDLTextureRAII> ResourceCache::LoadTexture(const std::filesystem
     std::filesystem::path absolutePath = std::filesystem::absolute(filePath);
 
     // Return cached texture if it was already loaded.
-    if (textures.contains(absolutePath))
-        return textures[absolutePath];
+    if (auto textureRAII = FindAndTouch(textures, absolutePath))
+        return textureRAII;
 
     MY_LOG(debug, "Loading texture: {}", filePath.string());
 
-    // Load the texture and cache it.
-    std::shared_ptr<SDLTextureRAII> textureRAII;
-    textureRAII = details::LoadTexture(renderer, absolutePath);
-    textures[absolutePath] = textureRAII;
+    // Image is decoded by the loader. Only the upload of the pixels to the GPU is done here. The decoded image is
+    // released after the upload unless it is cached for the pixel queries.
+    std::shared_ptr<SDLSurfaceRAII> surfaceRAII = TakeDecodedSurface(absolutePath);
+    std::shared_ptr<SDLTextureRAII> textureRAII = details::CreateTextureFromSurface(renderer, surfaceRAII->get());
+    Insert(textures, absolutePath, textureRAII, GetTextureBytes(textureRAII->get()));
     return textureRAII;
 }
 
@@ -59,12 +111,14 @@ std::shared_ptr<MusicRAII> ResourceCache::LoadMusic(const std::filesystem::path&
     std::filesystem::path absolutePath = std::filesystem::absolute(filePath);
 
     // Return cached music if it was already loaded.
-    if (musics.contains(absolutePath))
-        return musics[absolutePath];
+    if (auto musicRAII = FindAndTouch(musics, absolutePath))
+        return musicRAII;
 
-    // Load the music and cache it.
+    // Load the music and cache it. Music is streamed from the file, so the file size is counted.
     std::shared_ptr<MusicRAII> musicRAII = std::make_shared<MusicRAII>(absolutePath.string());
-    musics[absolutePath] = musicRAII;
+    std::error_code errorCode;
+    auto fileSize = std::filesystem::file_size(absolutePath, errorCode);
+    Insert(musics, absolutePath, musicRAII, errorCode ? 0 : static_cast<size_t>(fileSize));
     return musicRAII;
 }
 
@@ -74,12 +128,12 @@ std::shared_ptr<SoundEffectRAII> ResourceCache::LoadSoundEffect(const std::files
     std::filesystem::path absolutePath = std::filesystem::absolute(filePath);
 
     // Return cached sound effect if it was already loaded.
-    if (soundEffects.contains(absolutePath))
-        return soundEffects[absolutePath];
+    if (auto soundEffectRAII = FindAndTouch(soundEffects, absolutePath))
+        return soundEffectRAII;
 
     // Load the sound effect and cache it.
-    std::shared_ptr<SoundEffectRAII> soundEffectRAII = std::make_shared<SoundEffectRAII>(absolutePath.string());
-    soundEffects[absolutePath] = soundEffectRAII;
+    std::shared_ptr<SoundEffectRAII> soundEffectRAII = loader.TakeSoundEffect(absolutePath);
+    Insert(soundEffects, absolutePath, soundEffectRAII, soundEffectRAII->get()->alen);
     return soundEffectRAII;
 }
 
@@ -88,16 +142,74 @@ std::shared_ptr<SDLSurfaceRAII> ResourceCache::LoadSurface(const std::filesystem
     // Get absolute path to the file.
     std::filesystem::path absolutePath = std::filesystem::absolute(filePath);
 
+    // Surface stays cached for the pixel queries even after the texture is created from it.
+    pixelQuerySurfaces.insert(absolutePath);
+
     // Return cached surface if it was already loaded.
-    if (surfaces.contains(absolutePath))
-        return surfaces[absolutePath];
+    if (auto surfaceRAII = FindAndTouch(surfaces, absolutePath))
+        return surfaceRAII;
 
     // Load the surface and cache it.
-    std::shared_ptr<SDLSurfaceRAII> surfaceRAII = details::LoadSurfaceWithStreamingAccess(absolutePath);
-    surfaces[absolutePath] = surfaceRAII;
+    std::shared_ptr<SDLSurfaceRAII> surfaceRAII = loader.TakeSurface(absolutePath);
+    Insert(surfaces, absolutePath, surfaceRAII, GetSurfaceBytes(surfaceRAII->get()));
     return surfaceRAII;
 }
 
+AtlasRegion ResourceCache::LoadAtlasRegion(const std::filesystem::path& filePath)
+{
+    // Get absolute path to the file.
+    std::filesystem::path absolutePath = std::filesystem::absolute(filePath);
+
+    // Return cached region if the image was already packed.
+    if (atlasRegions.contains(absolutePath))
+        return atlasRegions[absolutePath];
+
+    // Surface has the same layout as the texture, so it is used for the pixel queries by the same rects.
+    if (!utils::GetConfig<bool, "TextureAtlas.enabled">())
+    {
+        std::shared_ptr<SDLSurfaceRAII> surfaceRAII = LoadSurface(absolutePath);
+        return {LoadTexture(absolutePath), surfaceRAII, {0, 0, surfaceRAII->get()->w, surfaceRAII->get()->h}};
+    }
+
+    // Pixels are copied to the page, which keeps its own CPU copy. The decoded image is released after packing.
+    std::shared_ptr<SDLSurfaceRAII> imageSurface = TakeDecodedSurface(absolutePath);
+
+    MY_LOG(debug, "Packing texture to the atlas: {}", filePath.string());
+    AtlasRegion region = atlas.Add(imageSurface->get());
+    atlasRegions[absolutePath] = region;
+    return region;
+}
+
+void ResourceCache::PrefetchImage(const std::filesystem::path& filePath)
+{
+    std::filesystem::path absolutePath = std::filesystem::absolute(filePath);
+    if (!textures.entries.contains(absolutePath) && !surfaces.entries.contains(absolutePath) &&
+        !atlasRegions.contains(absolutePath))
+        loader.RequestSurface(absolutePath);
+}
+
+void ResourceCache::PrefetchSoundEffect(const std::filesystem::path& filePath)
+{
+    std::filesystem::path absolutePath = std::filesystem::absolute(filePath);
+    if (!soundEffects.entries.contains(absolutePath))
+        loader.RequestSoundEffect(absolutePath);
+}
+
+void ResourceCache::CollectPrefetched()
+{
+    // Surfaces are found by LoadTexture and LoadAtlasRegion in the cache as well as in the loader.
+    for (auto& [absolutePath, surfaceRAII] : loader.TakeReadySurfaces())
+    {
+        const size_t bytes = GetSurfaceBytes(surfaceRAII->get());
+        Insert(surfaces, absolutePath, std::move(surfaceRAII), bytes);
+    }
+    for (auto& [absolutePath, soundEffectRAII] : loader.TakeReadySoundEffects())
+    {
+        const size_t bytes = soundEffectRAII->get()->alen;
+        Insert(soundEffects, absolutePath, std::move(soundEffectRAII), bytes);
+    }
+}
+
 std::shared_ptr<SDLTextureRAII> ResourceCache::GetColoredPixelTexture(const ColorName& color)
 {
     // Return cached texture if it was already loaded.
@@ -111,4 +223,101 @@ std::shared_ptr<SDLTextureRAII> ResourceCache::GetColoredPixelTexture(const Colo
     return textureRAII;
 }
 
-} // namespace details
\ No newline at end of file
+ResourceCacheStats ResourceCache::GetStats() const
+{
+    auto getUsage = [](const auto& entriesByPath)
+    { return ResourceCacheStats::Usage{entriesByPath.entries.size(), entriesByPath.bytes}; };
+
+    ResourceCacheStats stats;
+    stats.textures = getUsage(textures);
+    stats.surfaces = getUsage(surfaces);
+    stats.soundEffects = getUsage(soundEffects);
+    stats.musics = getUsage(musics);
+    stats.atlasPages = {atlas.GetPagesCount(), atlas.GetMemoryBytes()};
+    stats.budgetBytes = budgetBytes;
+    stats.evictedCount = evictedCount;
+    return stats;
+}
+
+std::shared_ptr<SDLSurfaceRAII> ResourceCache::TakeDecodedSurface(const std::filesystem::path& absolutePath)
+{
+    if (pixelQuerySurfaces.contains(absolutePath))
+    {
+        if (auto surfaceRAII = FindAndTouch(surfaces, absolutePath))
+            return surfaceRAII;
+        return loader.TakeSurface(absolutePath);
+    }
+
+    // Prefetched surface is consumed by the caller, so it is not kept in the cache and counted in the budget.
+    auto entryIt = surfaces.entries.find(absolutePath);
+    if (entryIt == surfaces.entries.end())
+        return loader.TakeSurface(absolutePath);
+
+    std::shared_ptr<SDLSurfaceRAII> surfaceRAII = std::move(entryIt->second.resource);
+    surfaces.bytes -= entryIt->second.bytes;
+    surfaces.entries.erase(entryIt);
+    return surfaceRAII;
+}
+
+template <typename T>
+std::shared_ptr<T> ResourceCache::FindAndTouch(
+    EntriesByPath<T>& entriesByPath, const std::filesystem::path& absolutePath)
+{
+    auto entryIt = entriesByPath.entries.find(absolutePath);
+    if (entryIt == entriesByPath.entries.end())
+        return nullptr;
+
+    entryIt->second.lastUse = ++useCounter;
+    return entryIt->second.resource;
+}
+
+template <typename T>
+void ResourceCache::Insert(
+    EntriesByPath<T>& entriesByPath, const std::filesystem::path& absolutePath, std::shared_ptr<T> resource,
+    size_t bytes)
+{
+    Entry<T>& entry = entriesByPath.entries[absolutePath];
+    entriesByPath.bytes += bytes - entry.bytes;
+    entry = {std::move(resource), bytes, ++useCounter};
+    EvictOverBudget();
+}
+
+void ResourceCache::EvictOverBudget()
+{
+    if (budgetBytes == 0)
+        return;
+
+    // Music is streamed from the file, so it is not counted.
+    size_t usedBytes = textures.bytes + surfaces.bytes + soundEffects.bytes + atlas.GetMemoryBytes();
+    if (usedBytes <= budgetBytes)
+        return;
+
+    // Entries referenced outside of the cache are in use, evicting them would not free the memory.
+    std::vector<EvictionCandidate> candidates;
+    auto collect = [&candidates](auto& entriesByPath, auto isEvictable)
+    {
+        for (const auto& [path, entry] : entriesByPath.entries)
+        {
+            if (entry.resource.use_count() != 1 || !isEvictable(*entry.resource))
+                continue;
+
+            auto evict = [&entriesByPath, path = path, bytes = entry.bytes]
+            {
+                entriesByPath.bytes -= bytes;
+                entriesByPath.entries.erase(path);
+            };
+            candidates.push_back({entry.lastUse, entry.bytes, std::move(evict)});
+        }
+    };
+    auto always = [](const auto&) { return true; };
+    collect(textures, always);
+    collect(surfaces, always);
+    collect(soundEffects, [](const SoundEffectRAII& soundEffect) { return !IsSoundEffectPlaying(soundEffect.get()); });
+    // Music is never evicted. The playing track is referenced only by SDL_mixer.
+
+    evictedCount += EvictLeastRecentlyUsed(std::move(candidates), usedBytes, budgetBytes);
+    if (usedBytes > budgetBytes)
+        MY_LOG(debug, "Resource cache uses {} bytes over the budget {}", usedBytes, budgetBytes);
+}
+
+} // namespace details
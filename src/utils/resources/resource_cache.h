@@ -1,16 +1,36 @@
 #pragma once
 #include "SDL_render.h"
+#include <cstdint>
 #include <filesystem>
+#include <functional>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
+#include <utils/resources/asset_loader.h>
+#include <utils/resources/resource_cache_stats.h>
+#include <utils/resources/texture_atlas.h>
 #include <utils/sdl/sdl_RAII.h>
 #include <utils/sdl/sdl_audio_RAII.h>
 #include <utils/sdl/sdl_colors.h>
+#include <vector>
 
 namespace details
 {
 
+// Cached entry which is not referenced outside of the cache.
+struct EvictionCandidate
+{
+    uint64_t lastUse;
+    size_t bytes;
+    std::function<void()> evict;
+};
+
+// Evict the least recently used candidates until the used bytes fit the budget. Return number of evicted entries.
+size_t EvictLeastRecentlyUsed(std::vector<EvictionCandidate> candidates, size_t& usedBytes, size_t budgetBytes);
+
 // Reponsible for low-level resource management like loading textures and sounds.
+// Resources not referenced outside of the cache are evicted in the least recently used order when the memory
+// budget is exceeded.
 class ResourceCache
 {
 public:
@@ -19,16 +39,57 @@ public:
     std::shared_ptr<SDLTextureRAII> GetColoredPixelTexture(const ColorName& color);
     std::shared_ptr<SDLTextureRAII> LoadTexture(const std::filesystem::path& filePath);
     std::shared_ptr<SDLSurfaceRAII> LoadSurface(const std::filesystem::path& filePath);
+    // Image packed into the texture atlas. Whole standalone texture if the atlas is disabled.
+    AtlasRegion LoadAtlasRegion(const std::filesystem::path& filePath);
     std::shared_ptr<MusicRAII> LoadMusic(const std::filesystem::path& filePath);
     std::shared_ptr<SoundEffectRAII> LoadSoundEffect(const std::filesystem::path& filePath);
+    // Start decoding of the file in the background. Next Load* call of the file waits for the result.
+    void PrefetchImage(const std::filesystem::path& filePath);
+    void PrefetchSoundEffect(const std::filesystem::path& filePath);
+    // Move the decoded prefetched files to the cache, where they are counted in the budget and may be evicted.
+    void CollectPrefetched();
+    [[nodiscard]] ResourceCacheStats GetStats() const;
 private:
+    template <typename T>
+    struct Entry
+    {
+        std::shared_ptr<T> resource;
+        size_t bytes = 0;
+        uint64_t lastUse = 0; // Value of the use counter on the last load.
+    };
+    template <typename T>
+    struct EntriesByPath
+    {
+        std::unordered_map<std::filesystem::path, Entry<T>> entries;
+        size_t bytes = 0; // Updated on insert and eviction, so the entries are not summed for the stats.
+    };
+
     SDL_Renderer* renderer;
+    TextureAtlas atlas;
+    AssetLoader loader;
+    size_t budgetBytes;
+    uint64_t useCounter = 0;
+    size_t evictedCount = 0;
 
     // Map absolute file paths to the textures/sounds.
     std::unordered_map<ColorName, std::shared_ptr<SDLTextureRAII>> coloredTextures;
-    std::unordered_map<std::filesystem::path, std::shared_ptr<SDLTextureRAII>> textures;
-    std::unordered_map<std::filesystem::path, std::shared_ptr<SDLSurfaceRAII>> surfaces;
-    std::unordered_map<std::filesystem::path, std::shared_ptr<MusicRAII>> musics;
-    std::unordered_map<std::filesystem::path, std::shared_ptr<SoundEffectRAII>> soundEffects;
+    EntriesByPath<SDLTextureRAII> textures;
+    EntriesByPath<SDLSurfaceRAII> surfaces;
+    // Surfaces loaded by LoadSurface, which stay cached after the texture is created from them.
+    std::unordered_set<std::filesystem::path> pixelQuerySurfaces;
+    std::unordered_map<std::filesystem::path, AtlasRegion> atlasRegions;
+    EntriesByPath<MusicRAII> musics;
+    EntriesByPath<SoundEffectRAII> soundEffects;
+private:
+    template <typename T>
+    std::shared_ptr<T> FindAndTouch(EntriesByPath<T>& entriesByPath, const std::filesystem::path& absolutePath);
+    template <typename T>
+    void Insert(
+        EntriesByPath<T>& entriesByPath, const std::filesystem::path& absolutePath, std::shared_ptr<T> resource,
+        size_t bytes);
+    // Decoded image for the upload. It is removed from the cache unless it was requested for the pixel queries.
+    std::shared_ptr<SDLSurfaceRAII> TakeDecodedSurface(const std::filesystem::path& absolutePath);
+    // Evict the least recently used entries which are not referenced outside of the cache.
+    void EvictOverBudget();
 };
-} // namespace details
\ No newline at end of file
+} // namespace details
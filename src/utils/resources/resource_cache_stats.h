@@ -0,0 +1,25 @@
+#pragma once
+#include <cstddef>
+
+// Memory used by the cached resources. Sizes are estimated from the dimensions and formats of the resources.
+struct ResourceCacheStats
+{
+    struct Usage
+    {
+        size_t count{0};
+        size_t bytes{0};
+    };
+
+    Usage textures;
+    Usage surfaces; // CPU copies of the images. Kept only while they are used for the pixel queries.
+    Usage soundEffects;
+    Usage musics; // Music is streamed, so the size of the file is shown. It is not counted in the total.
+    Usage atlasPages; // Texture and CPU copy of every page, so the page size is counted twice. Never evicted.
+    size_t budgetBytes{0}; // 0 - unlimited.
+    size_t evictedCount{0}; // Entries evicted since the start.
+
+    [[nodiscard]] size_t GetTotalBytes() const
+    {
+        return textures.bytes + surfaces.bytes + soundEffects.bytes + atlasPages.bytes;
+    }
+};
@@ -1,8 +1,10 @@
 #include "resource_manager.h"
 #include <SDL_rect.h>
+#include <chrono>
 #include <cstddef>
 #include <filesystem>
 #include <glob/glob.hpp>
+#include <limits>
 #include <my_cpp_utils/config.h>
 #include <my_cpp_utils/dict_utils.h>
 #include <my_cpp_utils/json_utils.h>
@@ -10,6 +12,8 @@
 #include <my_cpp_utils/string_utils.h>
 #include <nlohmann/detail/macro_scope.hpp>
 #include <nlohmann/json.hpp>
+#include <regex>
+#include <tuple>
 #include <utils/logger.h>
 #include <utils/resources/aseprite_data.h>
 #include <utils/resources/resource_cache.h>
@@ -18,12 +22,16 @@
 ResourceManager::ResourceManager(SDL_Renderer* renderer, const nlohmann::json& assetsSettingsJson)
   : resourceCashe(renderer)
 {
-    // Load animations.
+    const auto loadingStartTime = std::chrono::steady_clock::now();
+
+    // Read Aseprite files first. Images of all sheets are decoded in the background while the rest is parsed.
+    std::vector<std::tuple<FriendlyName, std::filesystem::path, AsepriteData>> asepriteAnimations;
     for (const auto& animationPair : assetsSettingsJson["animations"].items())
     {
-        const std::string& animationName = animationPair.key();
         auto animationPath = animationPair.value().get<std::filesystem::path>();
-        animations[animationName] = ReadAsepriteAnimation(animationPath);
+        AsepriteData asepriteData = ReadAsepriteData(animationPath);
+        resourceCashe.PrefetchImage(animationPath.parent_path() / asepriteData.texturePath);
+        asepriteAnimations.emplace_back(animationPair.key(), animationPath, std::move(asepriteData));
     }
 
     // Load tiled level names.
@@ -32,6 +40,7 @@ ResourceManager::ResourceManager(SDL_Renderer* renderer, const nlohmann::json& a
         LevelInfo levelInfo = tiledLevelPair.value().get<LevelInfo>();
         if (!std::filesystem::exists(levelInfo.tiledMapPath))
             throw std::runtime_error(MY_FMT("Tiled level file does not found: {}", levelInfo.tiledMapPath));
+        resourceCashe.PrefetchImage(levelInfo.backgroundPath);
         tiledLevels[levelInfo.name] = levelInfo;
     }
 
@@ -46,7 +55,8 @@ ResourceManager::ResourceManager(SDL_Renderer* renderer, const nlohmann::json& a
         if (!globAndVolumeShiftList.is_array())
             throw std::runtime_error(MY_FMT("Sound effect paths for '{}' should be an array", soundEffectName));
 
-        std::vector<SoundEffectBatch> soundEffectInfos;
+        SoundEffectGroup soundEffectGroup;
+        soundEffectGroup.name = soundEffectName;
 
         // Load sound effect paths.
         for (const auto& globAndVolumeShift : globAndVolumeShiftList)
@@ -61,18 +71,17 @@ ResourceManager::ResourceManager(SDL_Renderer* renderer, const nlohmann::json& a
             auto volumeShiftIt = globAndVolumeShift.find("volumeShift");
             float volumeShift = volumeShiftIt != globAndVolumeShift.end() ? volumeShiftIt->get<float>() : 0.0f;
 
-            SoundEffectBatch soundEffectInfo;
-            soundEffectInfo.volumeShift = volumeShift;
-
             for (auto& soundEffectPath : glob::glob(globPath))
             {
-                soundEffectInfo.paths.push_back(soundEffectPath);
+                // Decoded in the background, so the resolving of the sound doesn't stall the loading.
+                resourceCashe.PrefetchSoundEffect(soundEffectPath);
+                soundEffectGroup.trackPaths.push_back(std::filesystem::absolute(soundEffectPath));
+                soundEffectGroup.trackVolumeShifts.push_back(volumeShift);
             }
-
-            soundEffectInfos.push_back(soundEffectInfo);
         }
-        MY_LOG(debug, "Sound effect '{}' has {} batch(es)", soundEffectName, soundEffectInfos.size());
-        soundEffectBatchesPerTag[soundEffectName] = soundEffectInfos;
+        MY_LOG(debug, "Sound effect '{}' has {} track(s)", soundEffectName, soundEffectGroup.trackPaths.size());
+        soundEffectHandles[soundEffectName] = static_cast<SoundEffectHandle>(soundEffectGroups.size());
+        soundEffectGroups.push_back(std::move(soundEffectGroup));
     }
 
     // Load music.
@@ -83,12 +92,38 @@ ResourceManager::ResourceManager(SDL_Renderer* renderer, const nlohmann::json& a
         musicPaths[musicName] = musicPath;
     }
 
+    // Build animations. Clips are moved to the flat table first, pointers are taken when the table is complete.
+    // Packing of the sheets to the atlas waits for their images.
+    std::vector<std::pair<FriendlyName, FriendlyName>> clipNames; // Animation name and tag of the clip in the table.
+    for (auto& [animationName, animationPath, asepriteData] : asepriteAnimations)
+    {
+        for (auto& [tag, animation] : ReadAsepriteAnimation(animationPath, asepriteData))
+        {
+            // Clips without frames get one endless frame, so the playback needs no checks.
+            animation.firstFrameInTable = static_cast<uint32_t>(animationFrameDurations.size());
+            for (const auto& frame : animation.frames)
+                animationFrameDurations.push_back(frame.duration);
+            if (animation.frames.empty())
+                animationFrameDurations.push_back(std::numeric_limits<float>::infinity());
+
+            clipNames.emplace_back(animationName, tag);
+            animationClips.push_back(std::move(animation));
+        }
+    }
+    for (size_t i = 0; i < animationClips.size(); ++i)
+        animations[clipNames[i].first][clipNames[i].second] = &animationClips[i];
+
     MY_LOG(
-        info, "Game found {} animation(s), {} level(s), {} music(s), {} sound effect(s).", animations.size(),
-        tiledLevels.size(), musicPaths.size(), soundEffectBatchesPerTag.size());
+        info, "Game found {} animation(s) with {} clip(s), {} level(s), {} music(s), {} sound effect(s).",
+        animations.size(), animationClips.size(), tiledLevels.size(), musicPaths.size(),
+        soundEffectGroups.size());
+    MY_LOG(
+        info, "Resources loaded in {} ms",
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - loadingStartTime)
+            .count());
 }
 
-Animation ResourceManager::GetAnimation(const std::string& animationName)
+const Animation& ResourceManager::GetAnimation(const std::string& animationName)
 {
     if (!animations.contains(animationName))
         throw std::runtime_error(MY_FMT("Animation with name '{}' does not found", animationName));
@@ -97,61 +132,86 @@ Animation ResourceManager::GetAnimation(const std::string& animationName)
         throw std::runtime_error(MY_FMT("Animation with name '{}' has more than one tag", animationName));
 
     // Get first animation tag.
-    return animations[animationName].begin()->second;
+    return *animations[animationName].begin()->second;
 }
 
-Animation ResourceManager::GetAnimation(const std::string& animationName, const std::string& tagName, TagProps tagProps)
+const Animation& ResourceManager::GetAnimation(
+    const std::string& animationName, const std::string& tagName, TagProps tagProps)
 {
     if (tagProps == TagProps::ExactMatch)
         return GetAnimationExactMatch(animationName, tagName);
 
     if (tagProps == TagProps::RandomByRegex)
-        return GetAnimationByRegexRandomly(animationName, tagName);
+        return GetRandomAnimationClip(ResolveAnimationClipGroup(animationName, tagName));
 
     throw std::runtime_error(MY_FMT("Unknown TagProps: {}", static_cast<int>(tagProps)));
 }
 
-Animation ResourceManager::GetAnimationExactMatch(const std::string& animationName, const std::string& tagName)
+const Animation& ResourceManager::GetAnimationExactMatch(const std::string& animationName, const std::string& tagName)
 {
-    if (!animations.contains(animationName))
+    auto animationIt = animations.find(animationName);
+    if (animationIt == animations.end())
         throw std::runtime_error(MY_FMT("Animation with name '{}' does not found", animationName));
 
-    if (!animations[animationName].contains(tagName))
+    auto tagIt = animationIt->second.find(tagName);
+    if (tagIt == animationIt->second.end())
         throw std::runtime_error(MY_FMT("Animation tag with name '{}' does not found in {}", tagName, animationName));
 
-    return animations[animationName][tagName];
+    return *tagIt->second;
 }
 
-Animation ResourceManager::GetAnimationByRegexRandomly(
+AnimationClipGroupHandle ResourceManager::ResolveAnimationClipGroup(
     const std::string& animationName, const std::string& regexTagName)
 {
-    if (!animations.contains(animationName))
+    auto animationIt = animations.find(animationName);
+    if (animationIt == animations.end())
         throw std::runtime_error(MY_FMT("Animation with name '{}' does not found", animationName));
 
-    std::vector<std::string> foundTags;
-    for (const auto& [tag, _] : animations[animationName])
+    auto& tagRegexToClipGroup = clipGroupsByTagRegex[animationName];
+    auto clipGroupIt = tagRegexToClipGroup.find(regexTagName);
+    if (clipGroupIt != tagRegexToClipGroup.end())
+        return clipGroupIt->second;
+
+    std::vector<const Animation*> foundClips;
+    const std::regex tagRegex(regexTagName);
+    for (const auto& [tag, clip] : animationIt->second)
     {
-        if (std::regex_match(tag, std::regex(regexTagName)))
-            foundTags.push_back(tag);
+        if (std::regex_match(tag, tagRegex))
+            foundClips.push_back(clip);
     }
 
-    if (foundTags.empty())
+    if (foundClips.empty())
         throw std::runtime_error(
             MY_FMT("Animation tag with regex '{}' does not found in {}", regexTagName, animationName));
 
-    auto randomTagOpt = utils::RandomIndexOpt(foundTags);
-    return animations[animationName][foundTags[randomTagOpt.value()]];
+    auto clipGroup = static_cast<AnimationClipGroupHandle>(clipGroups.size());
+    clipGroups.push_back(std::move(foundClips));
+    tagRegexToClipGroup.emplace(regexTagName, clipGroup);
+    return clipGroup;
+}
+
+const Animation& ResourceManager::GetRandomAnimationClip(AnimationClipGroupHandle clipGroup) const
+{
+    const auto& clips = clipGroups[static_cast<size_t>(clipGroup)];
+    return *clips[utils::RandomIndexOpt(clips).value()];
 }
 
 namespace
 {
 
+// Rect of the frame in the atlas page.
+SDL_Rect GetRectInAtlas(const SDL_Rect& rectInTexture, const AtlasRegion& atlasRegion)
+{
+    return {
+        atlasRegion.rect.x + rectInTexture.x, atlasRegion.rect.y + rectInTexture.y, rectInTexture.w, rectInTexture.h};
+}
+
 AnimationFrame GetAnimationFrameFromAsepriteFrame(
-    const AsepriteData::Frame& asepriteFrame, std::shared_ptr<SDLTextureRAII> textureRAII)
+    const AsepriteData::Frame& asepriteFrame, const AtlasRegion& atlasRegion)
 {
     AnimationFrame animationFrame;
-    animationFrame.tileComponent.texturePtr = textureRAII;
-    animationFrame.tileComponent.textureRect = asepriteFrame.rectInTexture;
+    animationFrame.tileComponent.texturePtr = atlasRegion.texture;
+    animationFrame.tileComponent.textureRect = GetRectInAtlas(asepriteFrame.rectInTexture, atlasRegion);
     animationFrame.tileComponent.sizeWorld = {asepriteFrame.rectInTexture.w, asepriteFrame.rectInTexture.h};
     animationFrame.duration = asepriteFrame.duration_seconds;
     return animationFrame;
@@ -159,27 +219,27 @@ AnimationFrame GetAnimationFrameFromAsepriteFrame(
 
 } // namespace
 
-ResourceManager::TagToAnimationDict ResourceManager::ReadAsepriteAnimation(
-    const std::filesystem::path& asepriteAnimationJsonPath)
+AsepriteData ResourceManager::ReadAsepriteData(const std::filesystem::path& asepriteAnimationJsonPath)
 {
     auto asepriteJsonData = utils::LoadJsonFromFile(asepriteAnimationJsonPath);
 
-    AsepriteData asepriteData;
     try
     {
-        asepriteData = LoadAsepriteData(asepriteJsonData);
+        return LoadAsepriteData(asepriteJsonData);
     }
     catch (const std::exception& e)
     {
         throw std::runtime_error(MY_FMT(
-            "[ReadAsepriteAnimation] Failed to load Aseprite data from '{}': {}", asepriteAnimationJsonPath, e.what()));
+            "[ReadAsepriteData] Failed to load Aseprite data from '{}': {}", asepriteAnimationJsonPath, e.what()));
     }
+}
 
-    // Load texture.
+ResourceManager::TagToAnimationDict ResourceManager::ReadAsepriteAnimation(
+    const std::filesystem::path& asepriteAnimationJsonPath, AsepriteData& asepriteData)
+{
+    // Load texture. Surface of the atlas page is needed to get hitbox rect.
     auto animationTexturePath = asepriteAnimationJsonPath.parent_path() / asepriteData.texturePath;
-    std::shared_ptr<SDLTextureRAII> textureRAII = resourceCashe.LoadTexture(animationTexturePath);
-    // Surface with sreaming access is needed to get hitbox rect.
-    std::shared_ptr<SDLSurfaceRAII> surfaceRAII = resourceCashe.LoadSurface(animationTexturePath);
+    AtlasRegion atlasRegion = resourceCashe.LoadAtlasRegion(animationTexturePath);
 
     TagToAnimationDict tagToAnimationDict;
 
@@ -188,8 +248,9 @@ ResourceManager::TagToAnimationDict ResourceManager::ReadAsepriteAnimation(
         std::optional<SDL_Rect> hitboxRect;
         if (asepriteData.frameTags.contains("Hitbox"))
         {
-            const SDL_Rect& rectInSurface = asepriteData.frames[asepriteData.frameTags["Hitbox"].from].rectInTexture;
-            hitboxRect = GetVisibleRectInSrcRectCoordinates(surfaceRAII->get(), rectInSurface);
+            const SDL_Rect& rectInTexture = asepriteData.frames[asepriteData.frameTags["Hitbox"].from].rectInTexture;
+            const SDL_Rect rectInSurface = GetRectInAtlas(rectInTexture, atlasRegion);
+            hitboxRect = GetVisibleRectInSrcRectCoordinates(atlasRegion.surface->get(), rectInSurface);
             MY_LOG(
                 debug, "Hitbox rect found: x={}, y={}, w={}, h={}", hitboxRect->x, hitboxRect->y, hitboxRect->w,
                 hitboxRect->h);
@@ -204,7 +265,7 @@ ResourceManager::TagToAnimationDict ResourceManager::ReadAsepriteAnimation(
             animation.hitboxRect = hitboxRect;
             for (size_t i = frameTag.from; i <= frameTag.to; ++i)
             {
-                AnimationFrame animationFrame = GetAnimationFrameFromAsepriteFrame(asepriteData.frames[i], textureRAII);
+                AnimationFrame animationFrame = GetAnimationFrameFromAsepriteFrame(asepriteData.frames[i], atlasRegion);
 
                 MY_LOG(
                     debug, "Frame {} has texture rect: x={}, y={}, w={}, h={}", i,
@@ -222,7 +283,7 @@ ResourceManager::TagToAnimationDict ResourceManager::ReadAsepriteAnimation(
         Animation animation;
         for (size_t i = 0; i < asepriteData.frames.size(); ++i)
         {
-            AnimationFrame animationFrame = GetAnimationFrameFromAsepriteFrame(asepriteData.frames[i], textureRAII);
+            AnimationFrame animationFrame = GetAnimationFrameFromAsepriteFrame(asepriteData.frames[i], atlasRegion);
             animation.frames.push_back(std::move(animationFrame));
         }
         tagToAnimationDict[""] = animation;
@@ -261,26 +322,38 @@ std::shared_ptr<MusicRAII> ResourceManager::GetMusic(const std::string& name)
     return resourceCashe.LoadMusic(musicPaths[name]);
 }
 
-ResourceManager::SoundEffectInfo ResourceManager::GetSoundEffect(const std::string& name)
+SoundEffectHandle ResourceManager::ResolveSoundEffect(const std::string& name)
 {
-    if (!soundEffectBatchesPerTag.contains(name))
+    auto handleIt = soundEffectHandles.find(name);
+    if (handleIt == soundEffectHandles.end())
         throw std::runtime_error(MY_FMT("Sound effect with name '{}' does not found", name));
 
-    // Get random sound effect from the list.
-    const auto& soundEffectBatches = soundEffectBatchesPerTag[name];
-    auto batchNumberOpt = utils::RandomIndexOpt(soundEffectBatches);
-    if (!batchNumberOpt.has_value())
-        throw std::runtime_error(MY_FMT("Sound effect batch for '{}' is empty", name));
-    const SoundEffectBatch& soundEffectBatch = soundEffectBatches[batchNumberOpt.value()];
-    auto trackNumberOpt = utils::RandomIndexOpt(soundEffectBatch.paths);
-    if (!trackNumberOpt.has_value())
-        throw std::runtime_error(MY_FMT("Sound effect track number for '{}' is empty", name));
-    const auto& soundEffectPath = soundEffectBatch.paths[trackNumberOpt.value()];
-
-    SoundEffectInfo soundEffectInfo;
-    soundEffectInfo.soundEffect = resourceCashe.LoadSoundEffect(soundEffectPath);
-    soundEffectInfo.volumeShift = soundEffectBatch.volumeShift;
-    return soundEffectInfo;
+    SoundEffectGroup& soundEffectGroup = soundEffectGroups[static_cast<size_t>(handleIt->second)];
+    if (soundEffectGroup.trackPaths.empty())
+        throw std::runtime_error(MY_FMT("Sound effect '{}' has no tracks", name));
+
+    // Tracks are held by the group, so they are referenced outside of the cache and never evicted.
+    if (soundEffectGroup.tracks.empty())
+    {
+        for (size_t i = 0; i < soundEffectGroup.trackPaths.size(); ++i)
+        {
+            soundEffectGroup.tracks.push_back(
+                {resourceCashe.LoadSoundEffect(soundEffectGroup.trackPaths[i]), soundEffectGroup.trackVolumeShifts[i]});
+        }
+    }
+
+    return handleIt->second;
+}
+
+const ResourceManager::SoundEffectInfo& ResourceManager::GetSoundEffect(SoundEffectHandle soundEffect) const
+{
+    const auto& tracks = soundEffectGroups[static_cast<size_t>(soundEffect)].tracks;
+    return tracks[utils::Random<size_t>(0, tracks.size() - 1)];
+}
+
+const std::string& ResourceManager::GetSoundEffectName(SoundEffectHandle soundEffect) const
+{
+    return soundEffectGroups[static_cast<size_t>(soundEffect)].name;
 }
 
 std::shared_ptr<SDLSurfaceRAII> ResourceManager::GetSurface(const std::filesystem::path& path)
@@ -288,6 +361,11 @@ std::shared_ptr<SDLSurfaceRAII> ResourceManager::GetSurface(const std::filesyste
     return resourceCashe.LoadSurface(path);
 }
 
+AtlasRegion ResourceManager::GetAtlasRegion(const std::filesystem::path& path)
+{
+    return resourceCashe.LoadAtlasRegion(path);
+}
+
 std::shared_ptr<SDLTextureRAII> ResourceManager::GetColoredPixelTexture(ColorName color)
 {
     return resourceCashe.GetColoredPixelTexture(color);
@@ -1,14 +1,25 @@
 #pragma once
 #include <SDL_render.h>
+#include <cstdint>
 #include <filesystem>
 #include <memory>
 #include <unordered_map>
 #include <utils/animation.h>
 #include <utils/level_info.h>
+#include <utils/resources/aseprite_data.h>
 #include <utils/resources/resource_cache.h>
 #include <utils/sdl/sdl_RAII.h>
 #include <utils/sdl/sdl_colors.h>
 
+// Compact handles of the resources resolved by name once. Valid as long as the ResourceManager. Access by a handle is
+// an index into the array, so the hot paths don't hash the names.
+enum class SoundEffectHandle : uint32_t
+{
+};
+enum class AnimationClipGroupHandle : uint32_t
+{
+};
+
 // High-level resource management. Get resources by friendly names in game like terminolgy.
 // Every Get* method define specific resource type and return it by friendly name.
 // Example of resource map file `resourceMapFilePath` content:
@@ -38,18 +49,30 @@ public:
         float volumeShift = 0.0f;
     };
 private:
-    struct SoundEffectBatch
+    // Tracks of all batches of the sound effect. Sounds are loaded when the handle is resolved and held until the end,
+    // so the cache doesn't evict them between the plays and the play doesn't load anything.
+    struct SoundEffectGroup
     {
-        std::vector<std::filesystem::path> paths;
-        float volumeShift = 0.0f;
+        FriendlyName name;
+        std::vector<std::filesystem::path> trackPaths;
+        std::vector<float> trackVolumeShifts; // Volume shift of the batch of the track.
+        std::vector<SoundEffectInfo> tracks; // Same order as the paths. Empty until the handle is resolved.
     };
     details::ResourceCache resourceCashe;
     using FriendlyName = std::string;
     using TagToAnimationDict = std::unordered_map<FriendlyName, Animation>;
-    std::unordered_map<FriendlyName, TagToAnimationDict> animations;
+    using TagToClipDict = std::unordered_map<FriendlyName, const Animation*>;
+    using TagRegexToClipGroupDict = std::unordered_map<std::string, AnimationClipGroupHandle>;
+    // Flat table of all clips. Filled once in the constructor and never changed, so pointers to the clips are stable.
+    std::vector<Animation> animationClips;
+    std::vector<float> animationFrameDurations; // Durations of the frames of all clips. Clip frames are contiguous.
+    std::unordered_map<FriendlyName, TagToClipDict> animations;
+    std::vector<std::vector<const Animation*>> clipGroups; // Indexed by AnimationClipGroupHandle.
+    std::unordered_map<FriendlyName, TagRegexToClipGroupDict> clipGroupsByTagRegex; // Filled on the first request.
     std::unordered_map<FriendlyName, LevelInfo> tiledLevels;
     std::unordered_map<FriendlyName, std::filesystem::path> musicPaths;
-    std::unordered_map<std::string, std::vector<SoundEffectBatch>> soundEffectBatchesPerTag;
+    std::vector<SoundEffectGroup> soundEffectGroups; // Indexed by SoundEffectHandle.
+    std::unordered_map<FriendlyName, SoundEffectHandle> soundEffectHandles;
 public:
     ResourceManager(SDL_Renderer* renderer, const nlohmann::json& assetsSettingsJson);
 public: // //////////////////////////////////////// Animations ////////////////////////////////////////
@@ -58,21 +81,39 @@ public: // //////////////////////////////////////// Animations /////////////////
         ExactMatch,
         RandomByRegex
     };
+    // Clips are immutable and live as long as the ResourceManager. Components keep pointers to them.
     // Get animation by name without tag. Load the first tag found.
-    Animation GetAnimation(const std::string& animationName);
-    Animation GetAnimation(
+    const Animation& GetAnimation(const std::string& animationName);
+    const Animation& GetAnimation(
         const std::string& animationName, const std::string& tagName, TagProps tagProps = TagProps::ExactMatch);
+    const std::vector<float>& GetAnimationFrameDurations() const { return animationFrameDurations; }
+    // Clips of the animation which tags match the regex. The regex is matched once per animation and regex.
+    AnimationClipGroupHandle ResolveAnimationClipGroup(
+        const std::string& animationName, const std::string& regexTagName);
+    const Animation& GetRandomAnimationClip(AnimationClipGroupHandle clipGroup) const;
 private:
-    Animation GetAnimationExactMatch(const std::string& animationName, const std::string& tagName);
-    Animation GetAnimationByRegexRandomly(const std::string& animationName, const std::string& regexTagName);
-    TagToAnimationDict ReadAsepriteAnimation(const std::filesystem::path& asepriteAnimationJsonPath);
+    const Animation& GetAnimationExactMatch(const std::string& animationName, const std::string& tagName);
+    static AsepriteData ReadAsepriteData(const std::filesystem::path& asepriteAnimationJsonPath);
+    // Pack the sheet of the animation to the atlas and split it into the clips by the tags.
+    TagToAnimationDict ReadAsepriteAnimation(
+        const std::filesystem::path& asepriteAnimationJsonPath, AsepriteData& asepriteData);
 public: // //////////////////////////////////////// Tiled levels ////////////////////////////////////////
     LevelInfo GetTiledLevel(const std::string& name);
 public: // ////////////////////////////////////////// Textures //////////////////////////////////////////
     std::shared_ptr<SDLTextureRAII> GetColoredPixelTexture(ColorName color);
     std::shared_ptr<SDLTextureRAII> GetTexture(const std::filesystem::path& path);
     std::shared_ptr<SDLSurfaceRAII> GetSurface(const std::filesystem::path& path);
+    // Texture and surface of the atlas page with the image. Rects in the image should be shifted by the region rect.
+    AtlasRegion GetAtlasRegion(const std::filesystem::path& path);
 public: // /////////////////////////////////////////// Sounds ///////////////////////////////////////////
     std::shared_ptr<MusicRAII> GetMusic(const std::string& name);
-    SoundEffectInfo GetSoundEffect(const std::string& name);
+    // Load the tracks of the sound effect. They stay loaded as long as the ResourceManager.
+    [[nodiscard]] SoundEffectHandle ResolveSoundEffect(const std::string& name);
+    // Random track of the sound effect. Tracks of all batches are equally likely.
+    [[nodiscard]] const SoundEffectInfo& GetSoundEffect(SoundEffectHandle soundEffect) const;
+    [[nodiscard]] const std::string& GetSoundEffectName(SoundEffectHandle soundEffect) const;
+public: // /////////////////////////////////////////// Memory ///////////////////////////////////////////
+    [[nodiscard]] ResourceCacheStats GetCacheStats() const { return resourceCashe.GetStats(); }
+    // Images and sound effects decoded in the background are moved to the cache. Called once per frame.
+    void CollectPrefetchedResources() { resourceCashe.CollectPrefetched(); }
 };
\ No newline at end of file
@@ -0,0 +1,176 @@
+#include "texture_atlas.h"
+#include <algorithm>
+#include <limits>
+#include <my_cpp_utils/config.h>
+#include <stdexcept>
+#include <utils/logger.h>
+#include <utils/sdl/sdl_texture_process.h>
+
+SkylinePacker::SkylinePacker(int width, int height) : width(width), height(height)
+{
+    skyline.push_back({0, 0, width});
+}
+
+std::optional<SDL_Point> SkylinePacker::Insert(int rectWidth, int rectHeight)
+{
+    // Bottom-left: the lowest top border of the placed rect wins, the narrowest segment breaks the ties.
+    std::optional<size_t> bestIndex;
+    int bestBottom = std::numeric_limits<int>::max();
+    int bestWidth = std::numeric_limits<int>::max();
+    SDL_Point bestPos{};
+    for (size_t i = 0; i < skyline.size(); ++i)
+    {
+        auto yOpt = FitAtSegment(i, rectWidth, rectHeight);
+        if (!yOpt)
+            continue;
+
+        const int bottom = *yOpt + rectHeight;
+        if (bottom < bestBottom || (bottom == bestBottom && skyline[i].width < bestWidth))
+        {
+            bestIndex = i;
+            bestBottom = bottom;
+            bestWidth = skyline[i].width;
+            bestPos = {skyline[i].x, *yOpt};
+        }
+    }
+
+    if (!bestIndex)
+        return std::nullopt;
+
+    AddSegment(*bestIndex, bestPos, rectWidth, rectHeight);
+    return bestPos;
+}
+
+std::optional<int> SkylinePacker::FitAtSegment(size_t segmentIndex, int rectWidth, int rectHeight) const
+{
+    if (skyline[segmentIndex].x + rectWidth > width)
+        return std::nullopt;
+
+    // Rect lies on the highest segment under it.
+    int y = 0;
+    int widthLeft = rectWidth;
+    for (size_t i = segmentIndex; widthLeft > 0; ++i)
+    {
+        y = std::max(y, skyline[i].y);
+        if (y + rectHeight > height)
+            return std::nullopt;
+        widthLeft -= skyline[i].width;
+    }
+    return y;
+}
+
+void SkylinePacker::AddSegment(size_t segmentIndex, const SDL_Point& pos, int rectWidth, int rectHeight)
+{
+    skyline.insert(skyline.begin() + segmentIndex, {pos.x, pos.y + rectHeight, rectWidth});
+
+    // Cut the segments hidden under the new one.
+    const int newRight = pos.x + rectWidth;
+    for (size_t i = segmentIndex + 1; i < skyline.size();)
+    {
+        auto& segment = skyline[i];
+        if (segment.x >= newRight)
+            break;
+
+        const int shrink = newRight - segment.x;
+        if (segment.width <= shrink)
+        {
+            skyline.erase(skyline.begin() + i);
+            continue;
+        }
+
+        segment.x += shrink;
+        segment.width -= shrink;
+        break;
+    }
+
+    // Merge the neighbours of the same height.
+    for (size_t i = 0; i + 1 < skyline.size();)
+    {
+        if (skyline[i].y == skyline[i + 1].y)
+        {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + i + 1);
+            continue;
+        }
+        ++i;
+    }
+}
+
+TextureAtlas::TextureAtlas(SDL_Renderer* renderer)
+  : renderer(renderer), pageSize(utils::GetConfig<int, "TextureAtlas.pageSize">()),
+    padding(utils::GetConfig<int, "TextureAtlas.padding">())
+{
+    if (pageSize <= 0 || padding < 0)
+        throw std::runtime_error("[TextureAtlas] Page size must be positive and padding must not be negative");
+}
+
+AtlasRegion TextureAtlas::Add(SDL_Surface* image)
+{
+    if (!image)
+        throw std::runtime_error("[TextureAtlas] Image is NULL");
+
+    const int paddedWidth = image->w + padding;
+    const int paddedHeight = image->h + padding;
+
+    Page* page = nullptr;
+    SDL_Point pos{};
+    for (auto& candidatePage : pages)
+    {
+        if (auto posOpt = candidatePage.packer.Insert(paddedWidth, paddedHeight))
+        {
+            page = &candidatePage;
+            pos = *posOpt;
+            break;
+        }
+    }
+
+    if (!page)
+    {
+        page = &CreatePage(std::max(pageSize, paddedWidth), std::max(pageSize, paddedHeight));
+        pos = page->packer.Insert(paddedWidth, paddedHeight).value();
+    }
+
+    // Exact copy of the pixels, alpha included.
+    SDL_Rect rect = {pos.x, pos.y, image->w, image->h};
+    SDL_BlendMode imageBlendMode;
+    SDL_GetSurfaceBlendMode(image, &imageBlendMode);
+    SDL_SetSurfaceBlendMode(image, SDL_BLENDMODE_NONE);
+    SDL_Rect destRect = rect;
+    if (SDL_BlitSurface(image, nullptr, page->surface->get(), &destRect) != 0)
+        throw std::runtime_error(MY_FMT("[TextureAtlas] Failed to copy the image: {}", SDL_GetError()));
+    SDL_SetSurfaceBlendMode(image, imageBlendMode);
+
+    SDL_Surface* pageSurface = page->surface->get();
+    const auto* pagePixels = static_cast<const Uint8*>(pageSurface->pixels);
+    const void* rectPixels = pagePixels + rect.y * pageSurface->pitch + rect.x * 4;
+    if (SDL_UpdateTexture(page->texture->get(), &rect, rectPixels, pageSurface->pitch) != 0)
+        throw std::runtime_error(MY_FMT("[TextureAtlas] Failed to update the page texture: {}", SDL_GetError()));
+
+    return {page->texture, page->surface, rect};
+}
+
+size_t TextureAtlas::GetMemoryBytes() const
+{
+    size_t bytes = 0;
+    for (const auto& page : pages)
+    {
+        // Texture has the same size and format as the surface.
+        const SDL_Surface* surface = page.surface->get();
+        bytes += 2 * static_cast<size_t>(surface->pitch) * surface->h;
+    }
+    return bytes;
+}
+
+TextureAtlas::Page& TextureAtlas::CreatePage(int width, int height)
+{
+    MY_LOG(debug, "[TextureAtlas] Creating page {} of size {}x{}", pages.size(), width, height);
+
+    // Surface is created zeroed, so the free space and the padding are transparent.
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ABGR8888);
+    if (!surface)
+        throw std::runtime_error(MY_FMT("[TextureAtlas] Failed to create the page surface: {}", SDL_GetError()));
+
+    auto texture = CreateStreamingTexture(renderer, width, height);
+    pages.push_back({texture, std::make_shared<SDLSurfaceRAII>(surface), SkylinePacker(width, height)});
+    return pages.back();
+}
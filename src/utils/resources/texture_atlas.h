@@ -0,0 +1,65 @@
+#pragma once
+#include <SDL.h>
+#include <memory>
+#include <optional>
+#include <utils/sdl/sdl_RAII.h>
+#include <vector>
+
+// Packs rectangles into a fixed size page with the skyline bottom-left heuristic. The skyline is the list of
+// segments of the upper border of the packed area, sorted by x.
+class SkylinePacker
+{
+    struct Segment
+    {
+        int x;
+        int y;
+        int width;
+    };
+
+    int width;
+    int height;
+    std::vector<Segment> skyline;
+public:
+    SkylinePacker(int width, int height);
+    // Return the top left corner of the placed rectangle or nullopt if the page is full.
+    std::optional<SDL_Point> Insert(int rectWidth, int rectHeight);
+private:
+    // Lowest y where the rectangle starting from the segment fits. Nullopt if it goes out of the page.
+    [[nodiscard]] std::optional<int> FitAtSegment(size_t segmentIndex, int rectWidth, int rectHeight) const;
+    void AddSegment(size_t segmentIndex, const SDL_Point& pos, int rectWidth, int rectHeight);
+};
+
+// Part of the atlas page with the image. Texture and surface have the same layout, so pixels of the image may be
+// read from the surface by the same rect.
+struct AtlasRegion
+{
+    std::shared_ptr<SDLTextureRAII> texture;
+    std::shared_ptr<SDLSurfaceRAII> surface; // SDL_PIXELFORMAT_ABGR8888.
+    SDL_Rect rect;
+};
+
+// Images loaded at start are packed into a few big pages, so sprites of different sources are drawn from one
+// texture and the sprite batches are not broken by the texture switches.
+class TextureAtlas
+{
+    struct Page
+    {
+        std::shared_ptr<SDLTextureRAII> texture;
+        std::shared_ptr<SDLSurfaceRAII> surface; // CPU copy of the page. Used for the pixel queries.
+        SkylinePacker packer;
+    };
+
+    SDL_Renderer* renderer;
+    int pageSize;
+    int padding; // Transparent pixels on the right and bottom of every image. Prevent bleeding on scaling.
+    std::vector<Page> pages;
+public:
+    explicit TextureAtlas(SDL_Renderer* renderer);
+    // Copy the image to the first page with free space. Images bigger than the page get their own page.
+    AtlasRegion Add(SDL_Surface* image);
+    [[nodiscard]] size_t GetPagesCount() const { return pages.size(); }
+    // Memory of the page textures and their CPU copies.
+    [[nodiscard]] size_t GetMemoryBytes() const;
+private:
+    Page& CreatePage(int width, int height);
+};
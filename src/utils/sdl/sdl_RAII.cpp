@@ -52,6 +52,15 @@ SDLRendererRAII::SDLRendererRAII(SDL_Window* window, Uint32 flags)
     }
 }
 
+SDLRendererRAII::SDLRendererRAII(SDL_Surface* surface)
+{
+    renderer = SDL_CreateSoftwareRenderer(surface);
+    if (!renderer)
+    {
+        throw std::runtime_error(MY_FMT("Failed to create SDL software Renderer: {}", SDL_GetError()));
+    }
+}
+
 SDLRendererRAII::~SDLRendererRAII()
 {
     if (renderer)
@@ -35,6 +35,8 @@ class SDLRendererRAII
     SDL_Renderer* renderer = nullptr;
 public:
     explicit SDLRendererRAII(SDL_Window* window, Uint32 flags);
+    // Software renderer drawing to the surface. Used without a window, e.g. for the offscreen benchmark.
+    explicit SDLRendererRAII(SDL_Surface* surface);
     ~SDLRendererRAII();
     SDLRendererRAII(const SDLRendererRAII&) = delete;
     SDLRendererRAII& operator=(const SDLRendererRAII&) = delete;
@@ -1,19 +1,22 @@
 #include "sdl_primitives_renderer.h"
 #include <glm/fwd.hpp>
+#include <my_cpp_utils/config.h>
 #include <numbers>
 #include <utils/sdl/sdl_colors.h>
 #include <utils/sdl/sdl_gfx_wrapper.h>
 #include <utils/sdl/sdl_utils.h>
 #include <vector>
 
-SdlPrimitivesRenderer::SdlPrimitivesRenderer(entt::registry& registry, SDL_Renderer* renderer)
+SdlPrimitivesRenderer::SdlPrimitivesRenderer(
+    entt::registry& registry, SDL_Renderer* renderer, const AnimationPlaybackPool& animationPlaybackPool)
   : renderer(renderer), gameState(registry.get<GameOptions>(registry.view<GameOptions>().front())),
-    coordinatesTransformer(registry)
+    coordinatesTransformer(registry), spriteBatcher(renderer), animationPlaybackPool(animationPlaybackPool)
 {}
 
 void SdlPrimitivesRenderer::RenderRect(
     const glm::vec2& posWorld, const glm::vec2& sizeWorld, float angle, ColorName color)
 {
+    FlushSprites();
     auto sdlColor = GetSDLColor(color);
     auto centerPosScreen = coordinatesTransformer.WorldToScreen(posWorld);
     auto sizeScreen = coordinatesTransformer.WorldToScreen(sizeWorld, CoordinatesTransformer::Type::Length);
@@ -35,43 +38,79 @@ void SdlPrimitivesRenderer::RenderRect(
 
 void SdlPrimitivesRenderer::RenderCircle(const glm::vec2& centerWorld, float radiusWorld, ColorName color)
 {
+    FlushSprites();
     auto centerScreen = coordinatesTransformer.WorldToScreen(centerWorld);
     auto radiusScreen = coordinatesTransformer.WorldToScreen(radiusWorld);
     auto sdlColor = GetSDLColor(color);
     DrawCircle(renderer, centerScreen, radiusScreen, sdlColor);
 }
 
+void SdlPrimitivesRenderer::RenderPolygon(const std::vector<glm::vec2>& verticesWorld, ColorName color)
+{
+    FlushSprites();
+    std::vector<glm::vec2> verticesScreen;
+    verticesScreen.reserve(verticesWorld.size());
+    for (const auto& vertexWorld : verticesWorld)
+        verticesScreen.push_back(coordinatesTransformer.WorldToScreen(vertexWorld));
+
+    DrawPoligon(renderer, verticesScreen, GetSDLColor(color));
+}
+
 void SdlPrimitivesRenderer::RenderTile(
     const TileComponent& tileInfo, const glm::vec2& centerWorld, const float angle, const SDL_RendererFlip& flip)
 {
-    auto sizeWorld = tileInfo.sizeWorld;
-    SDL_Rect destRect = GetRectWithCameraTransform(centerWorld, sizeWorld);
+    SDL_Texture* texture = tileInfo.texturePtr ? tileInfo.texturePtr->get() : nullptr;
+    RenderTile(texture, tileInfo.textureRect, centerWorld, tileInfo.sizeWorld, angle, tileInfo.colorName, flip);
+}
+
+void SdlPrimitivesRenderer::RenderTile(
+    SDL_Texture* texture, const SDL_Rect& textureRect, const glm::vec2& centerWorld, const glm::vec2& sizeWorld,
+    const float angle, ColorName colorName, const SDL_RendererFlip& flip)
+{
+    if (!texture)
+    {
+        RenderRect(centerWorld, sizeWorld, angle, colorName);
+        return;
+    }
 
-    if (!tileInfo.texturePtr)
+    if (utils::GetConfig<bool, "SdlPrimitivesRenderer.spriteBatching">())
     {
-        RenderRect(centerWorld, sizeWorld, angle, tileInfo.colorName);
+        const glm::vec2 centerScreen = coordinatesTransformer.WorldToScreen(centerWorld);
+        const glm::vec2 sizeScreen =
+            coordinatesTransformer.WorldToScreen(sizeWorld, CoordinatesTransformer::Type::Length);
+        spriteBatcher.Draw(texture, textureRect, centerScreen, sizeScreen, angle, flip);
         return;
     }
 
+    SDL_Rect destRect = GetRectWithCameraTransform(centerWorld, sizeWorld);
+
     // Calculate the angle in degrees.
     SDL_Point center = {destRect.w / 2, destRect.h / 2};
     double angleDegrees = angle * 180.0 / std::numbers::pi;
 
     // Render the tile with the calculated angle.
-    SDL_RenderCopyEx(
-        renderer, tileInfo.texturePtr->get(), &tileInfo.textureRect, &destRect, angleDegrees, &center, flip);
+    SDL_RenderCopyEx(renderer, texture, &textureRect, &destRect, angleDegrees, &center, flip);
+    gameState.debugInfo.drawCalls++;
 }
 
 void SdlPrimitivesRenderer::RenderAnimationComponent(
     const AnimationComponent& animationInfo, glm::vec2 centerWorld, float angle)
 {
-    if (animationInfo.animation.frames.empty())
-        return;
+    if (auto frameTile = GetAnimationFrameTile(animationInfo, centerWorld))
+        RenderTile(*frameTile, centerWorld, angle, animationInfo.flip);
+}
+
+const TileComponent* SdlPrimitivesRenderer::GetAnimationFrameTile(
+    const AnimationComponent& animationInfo, glm::vec2& centerWorld) const
+{
+    if (!animationInfo.clip || animationInfo.clip->frames.empty())
+        return nullptr;
 
     // TODO1: Unify using the modulo operator in interface.
-    auto safeIndex = animationInfo.currentFrameIndex % animationInfo.animation.frames.size();
+    auto safeIndex =
+        animationPlaybackPool.GetFrameIndex(animationInfo.playbackSlot) % animationInfo.clip->frames.size();
 
-    const auto& animation = animationInfo.animation;
+    const auto& animation = *animationInfo.clip;
     const auto& frame = animation.frames[safeIndex];
 
     MY_LOG(
@@ -91,7 +130,7 @@ void SdlPrimitivesRenderer::RenderAnimationComponent(
         centerWorld = hitboxNewCenter;
     }
 
-    RenderTile(frame.tileComponent, centerWorld, angle, animationInfo.flip);
+    return &frame.tileComponent;
 }
 
 void SdlPrimitivesRenderer::RenderAnimationFirstFrame(
@@ -111,6 +150,8 @@ void SdlPrimitivesRenderer::RenderAnimationFirstFrame(
 
 void SdlPrimitivesRenderer::RenderBackground(const BackgroundInfo& backgroundInfo)
 {
+    FlushSprites();
+
     auto textureRAII = backgroundInfo.texture;
     if (!textureRAII)
     {
@@ -141,6 +182,13 @@ void SdlPrimitivesRenderer::RenderBackground(const BackgroundInfo& backgroundInf
 
     // Render the background texture.
     SDL_RenderCopy(renderer, backgroundTexture, nullptr, &dstRect);
+    gameState.debugInfo.drawCalls++;
+}
+
+void SdlPrimitivesRenderer::FlushSprites()
+{
+    if (spriteBatcher.Flush())
+        gameState.debugInfo.drawCalls++;
 }
 
 //////////////////////// Helper methods ////////////////////////
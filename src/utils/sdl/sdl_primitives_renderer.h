@@ -4,9 +4,11 @@
 #include <ecs/components/animation_components.h>
 #include <ecs/components/rendering_components.h>
 #include <entt/entt.hpp>
+#include <utils/animation_playback_pool.h>
 #include <utils/box2d/box2d_RAII.h>
 #include <utils/coordinates_transformer.h>
 #include <utils/game_options.h>
+#include <utils/render/sprite_batcher.h>
 #include <utils/resources/resource_manager.h>
 #include <utils/sdl/sdl_colors.h>
 
@@ -15,18 +17,30 @@ class SdlPrimitivesRenderer
     SDL_Renderer* renderer;
     GameOptions& gameState;
     CoordinatesTransformer coordinatesTransformer;
+    SpriteBatcher spriteBatcher; // Textured tiles are batched. Other primitives flush the batch before drawing.
+    const AnimationPlaybackPool& animationPlaybackPool; // Current frames of the animations.
 public:
-    SdlPrimitivesRenderer(entt::registry& registry, SDL_Renderer* renderer);
+    SdlPrimitivesRenderer(
+        entt::registry& registry, SDL_Renderer* renderer, const AnimationPlaybackPool& animationPlaybackPool);
 public:
     void RenderRect(const glm::vec2& posWorld, const glm::vec2& sizeWorld, float angle, ColorName color);
     void RenderCircle(const glm::vec2& centerWorld, float radiusWorld, ColorName color);
+    void RenderPolygon(const std::vector<glm::vec2>& verticesWorld, ColorName color);
     void RenderTile(
         const TileComponent& tileInfo, const glm::vec2& centerWorld, const float angle,
         const SDL_RendererFlip& flip = SDL_FLIP_NONE);
+    // Same for the sprite captured without the tile. Nullptr texture is drawn as a colored rect.
+    void RenderTile(
+        SDL_Texture* texture, const SDL_Rect& textureRect, const glm::vec2& centerWorld, const glm::vec2& sizeWorld,
+        const float angle, ColorName colorName, const SDL_RendererFlip& flip = SDL_FLIP_NONE);
     void RenderAnimationComponent(const AnimationComponent& animationInfo, glm::vec2 centerWorld, float angle);
+    // Tile of the current frame. Center is shifted to place the hitbox at the body center. Nullptr if no frames.
+    const TileComponent* GetAnimationFrameTile(const AnimationComponent& animationInfo, glm::vec2& centerWorld) const;
     void RenderAnimationFirstFrame(
         const Animation& animation, glm::vec2 centerWorld, float angle, const SDL_RendererFlip& flip = SDL_FLIP_NONE);
     void RenderBackground(const BackgroundInfo& backgroundInfo);
+    // Should be called before drawing with the SDL_Renderer directly and at the end of the frame.
+    void FlushSprites();
 private: // Helper methods.
     SDL_Rect GetRectWithCameraTransform(const glm::vec2& posWorld, const glm::vec2& sizeWorld);
 };
\ No newline at end of file
@@ -5,49 +5,82 @@
 #include <utils/logger.h>
 #include <utils/sdl/sdl_RAII.h>
 
-bool IsTileInvisible(SDL_Surface* surface, const SDL_Rect& miniTextureSrcRect)
+TileAlphaCoverage GetTileAlphaCoverage(SDL_Surface* surface, const SDL_Rect& textureSrcRect)
 {
     if (!surface)
-        throw std::runtime_error("[IsTileInvisible] Surface is NULL");
+        throw std::runtime_error("[GetTileAlphaCoverage] Surface is NULL");
 
     SDLSurfaceLockRAII lock(surface);
 
     Uint32* pixels = static_cast<Uint32*>(surface->pixels);
     int pitch = surface->pitch;
 
-    for (int row = 0; row < miniTextureSrcRect.h; ++row)
+    TileAlphaCoverage coverage;
+    for (int row = 0; row < textureSrcRect.h; ++row)
     {
-        for (int col = 0; col < miniTextureSrcRect.w; ++col)
+        for (int col = 0; col < textureSrcRect.w; ++col)
         {
-            Uint32 pixel = pixels[(miniTextureSrcRect.y + row) * (pitch / 4) + (miniTextureSrcRect.x + col)];
+            Uint32 pixel = pixels[(textureSrcRect.y + row) * (pitch / 4) + (textureSrcRect.x + col)];
             Uint8 alpha = (pixel >> surface->format->Ashift) & 0xFF;
             if (alpha > 0)
-            {
-                return false;
-            }
+                coverage.hasVisiblePixels = true;
+            else
+                coverage.hasTransparentPixels = true;
+
+            if (coverage.hasVisiblePixels && coverage.hasTransparentPixels)
+                return coverage;
         }
     }
 
-    return true;
+    return coverage;
+}
+
+bool IsTileInvisible(SDL_Surface* surface, const SDL_Rect& miniTextureSrcRect)
+{
+    return !GetTileAlphaCoverage(surface, miniTextureSrcRect).hasVisiblePixels;
 }
 
 SDL_Rect CalculateSrcRect(int tileId, int tileWidth, int tileHeight, std::shared_ptr<SDLTextureRAII> texture)
 {
     int textureWidth, textureHeight;
     SDL_QueryTexture(texture->get(), nullptr, nullptr, &textureWidth, &textureHeight);
+    return CalculateSrcRect(tileId, tileWidth, tileHeight, SDL_Rect{0, 0, textureWidth, textureHeight});
+}
 
-    int tilesPerRow = textureWidth / tileWidth;
+SDL_Rect CalculateSrcRect(int tileId, int tileWidth, int tileHeight, const SDL_Rect& tilesetRect)
+{
+    int tilesPerRow = tilesetRect.w / tileWidth;
     tileId -= 1; // Adjust tileId to match 0-based indexing. Tiled uses 1-based indexing.
 
     SDL_Rect srcRect;
-    srcRect.x = (tileId % tilesPerRow) * tileWidth;
-    srcRect.y = (tileId / tilesPerRow) * tileHeight;
+    srcRect.x = tilesetRect.x + (tileId % tilesPerRow) * tileWidth;
+    srcRect.y = tilesetRect.y + (tileId / tilesPerRow) * tileHeight;
     srcRect.w = tileWidth;
     srcRect.h = tileHeight;
 
     return srcRect;
 }
 
+std::shared_ptr<SDLTextureRAII> CreateStreamingTexture(SDL_Renderer* renderer, int width, int height, Uint32 format)
+{
+    SDL_Texture* texture = SDL_CreateTexture(renderer, format, SDL_TEXTUREACCESS_STREAMING, width, height);
+    if (!texture)
+        throw std::runtime_error(MY_FMT("[CreateStreamingTexture] Failed to create texture: {}", SDL_GetError()));
+
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    return std::make_shared<SDLTextureRAII>(texture);
+}
+
+std::shared_ptr<SDLTextureRAII> CreateRenderTargetTexture(SDL_Renderer* renderer, int width, int height, Uint32 format)
+{
+    SDL_Texture* texture = SDL_CreateTexture(renderer, format, SDL_TEXTUREACCESS_TARGET, width, height);
+    if (!texture)
+        throw std::runtime_error(MY_FMT("[CreateRenderTargetTexture] Failed to create texture: {}", SDL_GetError()));
+
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    return std::make_shared<SDLTextureRAII>(texture);
+}
+
 SDL_Rect GetVisibleRectInSurfaceCoordinates(SDL_Surface* surface, const SDL_Rect& textureSrcRect)
 {
     if (!surface)
@@ -100,12 +133,12 @@ SDL_Rect GetVisibleRectInSrcRectCoordinates(SDL_Surface* surface, const SDL_Rect
 namespace details
 {
 
-std::shared_ptr<SDLTextureRAII> LoadTexture(SDL_Renderer* renderer, const std::filesystem::path& imagePath)
+std::shared_ptr<SDLTextureRAII> CreateTextureFromSurface(SDL_Renderer* renderer, SDL_Surface* surface)
 {
-    SDL_Texture* texture = IMG_LoadTexture(renderer, imagePath.string().c_str());
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
 
     if (texture == nullptr)
-        throw std::runtime_error(MY_FMT("Failed to load texture: {}", imagePath));
+        throw std::runtime_error(MY_FMT("Failed to create texture from surface: {}", SDL_GetError()));
 
     return std::make_shared<SDLTextureRAII>(texture);
 }
@@ -10,10 +10,28 @@ struct TextureRect
     SDL_Rect rect; // Rectangle in the texture corresponding to the tile.
 };
 
+struct TileAlphaCoverage
+{
+    bool hasVisiblePixels = false; // Some pixel has non-zero alpha.
+    bool hasTransparentPixels = false; // Some pixel has zero alpha.
+};
+
+// Scan of the rect stops as soon as both kinds of pixels are found.
+TileAlphaCoverage GetTileAlphaCoverage(SDL_Surface* surface, const SDL_Rect& textureSrcRect);
 bool IsTileInvisible(SDL_Surface* surface, const SDL_Rect& miniTextureSrcRect);
 
 // TileId is 1-based. Tiled uses 1-based indexing.
 SDL_Rect CalculateSrcRect(int tileId, int tileWidth, int tileHeight, std::shared_ptr<SDLTextureRAII> texture);
+// Same for the tileset placed in the rect of a bigger texture, e.g. the atlas page.
+SDL_Rect CalculateSrcRect(int tileId, int tileWidth, int tileHeight, const SDL_Rect& tilesetRect);
+
+// Create a texture which pixels may be updated with SDL_UpdateTexture. Alpha blending is enabled.
+std::shared_ptr<SDLTextureRAII> CreateStreamingTexture(
+    SDL_Renderer* renderer, int width, int height, Uint32 format = SDL_PIXELFORMAT_ABGR8888);
+
+// Create a texture which may be used as a render target. Alpha blending is enabled.
+std::shared_ptr<SDLTextureRAII> CreateRenderTargetTexture(
+    SDL_Renderer* renderer, int width, int height, Uint32 format = SDL_PIXELFORMAT_ABGR8888);
 
 // Function to get the visible rectangle of a surface in coordinates of the surface.
 SDL_Rect GetVisibleRectInSurfaceCoordinates(SDL_Surface* surface, const SDL_Rect& textureSrcRect);
@@ -23,7 +41,8 @@ SDL_Rect GetVisibleRectInSrcRectCoordinates(SDL_Surface* surface, const SDL_Rect
 
 namespace details
 {
-std::shared_ptr<SDLTextureRAII> LoadTexture(SDL_Renderer* renderer, const std::filesystem::path& imagePath);
+// Upload of the decoded image. Must be called from the thread which created the renderer.
+std::shared_ptr<SDLTextureRAII> CreateTextureFromSurface(SDL_Renderer* renderer, SDL_Surface* surface);
 
 // Loads a surface with streaming access. This can be useful to determine if a tile is invisible.
 std::shared_ptr<SDLSurfaceRAII> LoadSurfaceWithStreamingAccess(const std::filesystem::path& imagePath);
@@ -18,12 +18,17 @@ void AudioSystem::PlayMusic(const std::string& musicName)
     Mix_VolumeMusic(volume);
 }
 
-void AudioSystem::PlaySoundEffect(const std::string& soundEffectName)
+SoundEffectHandle AudioSystem::ResolveSoundEffect(const std::string& soundEffectName)
+{
+    return resourceManager.ResolveSoundEffect(soundEffectName);
+}
+
+void AudioSystem::PlaySoundEffect(SoundEffectHandle soundEffect)
 {
     if (masterVolume == 0.0f)
         return;
 
-    const auto& soundEffectInfo = resourceManager.GetSoundEffect(soundEffectName);
+    const auto& soundEffectInfo = resourceManager.GetSoundEffect(soundEffect);
 
     // Find a free channel to play the sound.
     int channel = Mix_PlayChannel(-1, soundEffectInfo.soundEffect->get(), 0);
@@ -37,7 +42,7 @@ void AudioSystem::PlaySoundEffect(const std::string& soundEffectName)
     float volumeCoef = 0.5f + volumeShift;
     int volume = static_cast<int>(volumeCoef * masterVolume * MIX_MAX_VOLUME);
 
-    MY_LOG(trace, "Playing sound effect: {} with volume: {}", soundEffectName, volume);
+    MY_LOG(trace, "Playing sound effect: {} with volume: {}", resourceManager.GetSoundEffectName(soundEffect), volume);
 
     Mix_Volume(channel, volume);
 }
\ No newline at end of file
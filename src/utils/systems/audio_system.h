@@ -9,5 +9,7 @@ class AudioSystem
 public:
     AudioSystem(ResourceManager& resourceManager);
     void PlayMusic(const std::string& musicName);
-    void PlaySoundEffect(const std::string& soundEffectName);
+    // Sound effects are resolved by name once, e.g. in the constructors of the systems.
+    [[nodiscard]] SoundEffectHandle ResolveSoundEffect(const std::string& soundEffectName);
+    void PlaySoundEffect(SoundEffectHandle soundEffect);
 };
\ No newline at end of file
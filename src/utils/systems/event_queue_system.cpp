@@ -12,8 +12,10 @@ void EventQueueSystem::Update(float deltaTime)
     {
         ImGui_ImplSDL2_ProcessEvent(&event);
 
+        // Render resets are not input. They must reach the application even if ImGui captures the input.
+        const bool isRenderReset = event.type == SDL_RENDER_TARGETS_RESET || event.type == SDL_RENDER_DEVICE_RESET;
         ImGuiIO& io = ImGui::GetIO();
-        if (io.WantCaptureMouse || io.WantCaptureKeyboard)
+        if (!isRenderReset && (io.WantCaptureMouse || io.WantCaptureKeyboard))
         {
             // The mouse or keyboard event was processed by ImGui, do not process in the application.
             continue;
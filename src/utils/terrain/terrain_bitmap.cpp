@@ -0,0 +1,148 @@
+#include "terrain_bitmap.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+TerrainBitmap::TerrainBitmap(const glm::vec2& originWorld, int widthPixels, int heightPixels, int chunkSize)
+  : originWorld(originWorld), widthPixels(widthPixels), heightPixels(heightPixels), chunkSize(chunkSize)
+{
+    if (widthPixels <= 0 || heightPixels <= 0 || chunkSize <= 0)
+        throw std::runtime_error("[TerrainBitmap] Size of the bitmap and size of the chunk must be positive");
+
+    chunksX = (widthPixels + chunkSize - 1) / chunkSize;
+    chunksY = (heightPixels + chunkSize - 1) / chunkSize;
+    chunks.resize(chunksX * chunksY);
+    for (auto& chunk : chunks)
+    {
+        chunk.pixels.resize(chunkSize * chunkSize, Pixel::Empty);
+        chunk.colors.resize(chunkSize * chunkSize, 0);
+    }
+}
+
+TerrainBitmap::Pixel TerrainBitmap::GetPixel(int x, int y) const
+{
+    if (!IsInside(x, y))
+        return Pixel::Empty;
+
+    const auto& chunk = chunks[GetChunkIndex(x, y)];
+    return chunk.pixels[(y % chunkSize) * chunkSize + (x % chunkSize)];
+}
+
+void TerrainBitmap::SetPixel(int x, int y, Pixel pixel, Uint32 color)
+{
+    if (!IsInside(x, y))
+        return;
+
+    auto& chunk = chunks[GetChunkIndex(x, y)];
+    const size_t indexInChunk = (y % chunkSize) * chunkSize + (x % chunkSize);
+    auto& chunkPixel = chunk.pixels[indexInChunk];
+    auto& chunkColor = chunk.colors[indexInChunk];
+
+    if (pixel == Pixel::Empty)
+        color = 0;
+
+    if (chunkColor != color)
+    {
+        chunkColor = color;
+        MarkTextureDirty(chunk, x % chunkSize, y % chunkSize);
+    }
+
+    if (chunkPixel == pixel)
+        return;
+
+    if (chunkPixel == Pixel::Empty)
+        chunk.filledPixels++;
+    else if (pixel == Pixel::Empty)
+        chunk.filledPixels--;
+
+    chunkPixel = pixel;
+    chunk.isCollidersDirty = true;
+}
+
+size_t TerrainBitmap::CarveCircle(const glm::vec2& centerWorld, float radiusWorld)
+{
+    const glm::ivec2 minPixel = WorldToPixel(centerWorld - glm::vec2(radiusWorld));
+    const glm::ivec2 maxPixel = WorldToPixel(centerWorld + glm::vec2(radiusWorld));
+    const glm::vec2 centerPixel = centerWorld - originWorld;
+    const float radiusSquared = radiusWorld * radiusWorld;
+
+    size_t clearedPixels = 0;
+    for (int y = std::max(minPixel.y, 0); y <= std::min(maxPixel.y, heightPixels - 1); ++y)
+    {
+        // Calculate the horizontal span of the circle for the row once. Keeps the inner loop branch-light.
+        const float dy = y + 0.5f - centerPixel.y;
+        const float dxSquared = radiusSquared - dy * dy;
+        if (dxSquared < 0)
+            continue;
+
+        const float dx = std::sqrt(dxSquared);
+        const int minX = std::max(static_cast<int>(std::ceil(centerPixel.x - dx - 0.5f)), 0);
+        const int maxX = std::min(static_cast<int>(std::floor(centerPixel.x + dx - 0.5f)), widthPixels - 1);
+
+        for (int x = minX; x <= maxX; ++x)
+        {
+            auto& chunk = chunks[GetChunkIndex(x, y)];
+            const size_t indexInChunk = (y % chunkSize) * chunkSize + (x % chunkSize);
+            auto& pixel = chunk.pixels[indexInChunk];
+            if (pixel != Pixel::Destructible)
+                continue;
+
+            pixel = Pixel::Empty;
+            chunk.colors[indexInChunk] = 0; // Transparent.
+            chunk.filledPixels--;
+            chunk.isCollidersDirty = true;
+            MarkTextureDirty(chunk, x % chunkSize, y % chunkSize);
+            clearedPixels++;
+        }
+    }
+
+    return clearedPixels;
+}
+
+SDL_Rect TerrainBitmap::GetChunkRectPixels(size_t chunkIndex) const
+{
+    const int chunkX = static_cast<int>(chunkIndex) % chunksX;
+    const int chunkY = static_cast<int>(chunkIndex) / chunksX;
+    const int x = chunkX * chunkSize;
+    const int y = chunkY * chunkSize;
+    return {x, y, std::min(chunkSize, widthPixels - x), std::min(chunkSize, heightPixels - y)};
+}
+
+glm::ivec2 TerrainBitmap::WorldToPixel(const glm::vec2& posWorld) const
+{
+    const glm::vec2 posPixel = posWorld - originWorld;
+    return {static_cast<int>(std::floor(posPixel.x)), static_cast<int>(std::floor(posPixel.y))};
+}
+
+glm::vec2 TerrainBitmap::PixelToWorld(const glm::vec2& posPixel) const
+{
+    return originWorld + posPixel;
+}
+
+//////////////////////// Helper methods ////////////////////////
+
+bool TerrainBitmap::IsInside(int x, int y) const
+{
+    return x >= 0 && y >= 0 && x < widthPixels && y < heightPixels;
+}
+
+size_t TerrainBitmap::GetChunkIndex(int x, int y) const
+{
+    return (y / chunkSize) * chunksX + (x / chunkSize);
+}
+
+void TerrainBitmap::MarkTextureDirty(Chunk& chunk, int x, int y)
+{
+    SDL_Rect& rect = chunk.textureDirtyRect;
+    if (rect.w == 0 || rect.h == 0)
+    {
+        rect = {x, y, 1, 1};
+        return;
+    }
+
+    const int minX = std::min(rect.x, x);
+    const int minY = std::min(rect.y, y);
+    const int maxX = std::max(rect.x + rect.w, x + 1);
+    const int maxY = std::max(rect.y + rect.h, y + 1);
+    rect = {minX, minY, maxX - minX, maxY - minY};
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <SDL.h>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+// Occupancy of the terrain with pixel resolution. The bitmap is split into square chunks. Explosions mark only the
+// touched chunks as dirty, so the cost of the crater depends on the crater size, not on the map size.
+class TerrainBitmap
+{
+public:
+    enum class Pixel : uint8_t
+    {
+        Empty,
+        Destructible,
+        Indestructible,
+    };
+
+    struct Chunk
+    {
+        std::vector<Pixel> pixels; // Row-major, chunkSize x chunkSize.
+        std::vector<Uint32> colors; // Same layout as pixels. SDL_PIXELFORMAT_ABGR8888. Empty pixels are transparent.
+        size_t filledPixels = 0; // Number of not empty pixels. Used to skip empty chunks.
+        bool isCollidersDirty = false; // Colliders of the chunk should be rebuilt.
+        SDL_Rect textureDirtyRect{}; // Chunk local rect of colors changed since the last texture upload.
+    };
+private:
+    glm::vec2 originWorld; // World position of the top left corner of the pixel (0, 0).
+    int widthPixels;
+    int heightPixels;
+    int chunkSize;
+    int chunksX;
+    int chunksY;
+    std::vector<Chunk> chunks;
+public:
+    TerrainBitmap(const glm::vec2& originWorld, int widthPixels, int heightPixels, int chunkSize);
+public: ////////////////////////////////////////////////// Pixels. //////////////////////////////////////////////////
+    // Pixels outside of the bitmap are empty.
+    [[nodiscard]] Pixel GetPixel(int x, int y) const;
+    void SetPixel(int x, int y, Pixel pixel, Uint32 color);
+    // Clear destructible pixels which centers are inside the circle. Return number of cleared pixels.
+    size_t CarveCircle(const glm::vec2& centerWorld, float radiusWorld);
+public: ////////////////////////////////////////////////// Chunks. //////////////////////////////////////////////////
+    [[nodiscard]] size_t GetChunksCount() const { return chunks.size(); }
+    [[nodiscard]] int GetChunkSize() const { return chunkSize; }
+    [[nodiscard]] Chunk& GetChunk(size_t chunkIndex) { return chunks[chunkIndex]; }
+    [[nodiscard]] const Chunk& GetChunk(size_t chunkIndex) const { return chunks[chunkIndex]; }
+    // Rectangle of the chunk in the bitmap pixels. Chunks on the right and bottom borders may be cut.
+    [[nodiscard]] SDL_Rect GetChunkRectPixels(size_t chunkIndex) const;
+public: /////////////////////////////////////////////// Coordinates. ////////////////////////////////////////////////
+    [[nodiscard]] glm::ivec2 WorldToPixel(const glm::vec2& posWorld) const;
+    // Pixel coordinates are not rounded here. Center of the pixel (x, y) is (x + 0.5, y + 0.5).
+    [[nodiscard]] glm::vec2 PixelToWorld(const glm::vec2& posPixel) const;
+    [[nodiscard]] glm::ivec2 GetSizePixels() const { return {widthPixels, heightPixels}; }
+private: ///////////////////////////////////////////////// Helpers. /////////////////////////////////////////////////
+    [[nodiscard]] bool IsInside(int x, int y) const;
+    [[nodiscard]] size_t GetChunkIndex(int x, int y) const;
+    void MarkTextureDirty(Chunk& chunk, int x, int y);
+};
@@ -0,0 +1,194 @@
+#include "terrain_contours.h"
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+
+namespace
+{
+
+// Contour points lie in the middle of the cell edges. Doubled coordinates keep them integer and exact.
+uint64_t PackPoint(const glm::ivec2& point)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(point.x)) << 32) | static_cast<uint32_t>(point.y);
+}
+
+glm::ivec2 UnpackPoint(uint64_t key)
+{
+    return {static_cast<int32_t>(key >> 32), static_cast<int32_t>(key & 0xFFFFFFFF)};
+}
+
+// Cell of marching squares is a square between the centers of 4 neighbour pixels.
+// Middles of the cell edges are in doubled coordinates relative to the top left pixel.
+enum CellEdge : uint8_t
+{
+    Top,
+    Right,
+    Bottom,
+    Left,
+    NoEdge,
+};
+
+const std::array<glm::ivec2, 4> cellEdgeMiddles = {{{1, 0}, {2, 1}, {1, 2}, {0, 1}}};
+
+// Segments for each case of marching squares. Index bits: top left - 8, top right - 4, bottom right - 2,
+// bottom left - 1. Segments are oriented to keep the solid on the right side. Saddles are resolved as not connected.
+constexpr std::array<std::array<CellEdge, 4>, 16> caseSegments = {{
+    {NoEdge, NoEdge, NoEdge, NoEdge}, // 0
+    {Left, Bottom, NoEdge, NoEdge}, // 1
+    {Bottom, Right, NoEdge, NoEdge}, // 2
+    {Left, Right, NoEdge, NoEdge}, // 3
+    {Right, Top, NoEdge, NoEdge}, // 4
+    {Left, Bottom, Right, Top}, // 5
+    {Bottom, Top, NoEdge, NoEdge}, // 6
+    {Left, Top, NoEdge, NoEdge}, // 7
+    {Top, Left, NoEdge, NoEdge}, // 8
+    {Top, Bottom, NoEdge, NoEdge}, // 9
+    {Top, Left, Bottom, Right}, // 10
+    {Top, Right, NoEdge, NoEdge}, // 11
+    {Right, Left, NoEdge, NoEdge}, // 12
+    {Right, Bottom, NoEdge, NoEdge}, // 13
+    {Bottom, Left, NoEdge, NoEdge}, // 14
+    {NoEdge, NoEdge, NoEdge, NoEdge}, // 15
+}};
+
+float DistanceToSegment(const glm::vec2& point, const glm::vec2& segmentStart, const glm::vec2& segmentEnd)
+{
+    const glm::vec2 segment = segmentEnd - segmentStart;
+    const float segmentLengthSquared = glm::dot(segment, segment);
+    if (segmentLengthSquared == 0.0f)
+        return glm::distance(point, segmentStart);
+
+    const float t = glm::clamp(glm::dot(point - segmentStart, segment) / segmentLengthSquared, 0.0f, 1.0f);
+    return glm::distance(point, segmentStart + t * segment);
+}
+
+} // namespace
+
+namespace utils
+{
+
+std::vector<std::vector<glm::vec2>> TraceTerrainContours(
+    const TerrainBitmap& bitmap, const SDL_Rect& rectPixels, TerrainBitmap::Pixel solidPixel)
+{
+    auto isSolid = [&](int x, int y)
+    {
+        if (x < rectPixels.x || y < rectPixels.y || x >= rectPixels.x + rectPixels.w ||
+            y >= rectPixels.y + rectPixels.h)
+            return false;
+        return bitmap.GetPixel(x, y) == solidPixel;
+    };
+
+    // Collect oriented segments. Every contour point is the start of exactly one segment.
+    std::unordered_map<uint64_t, glm::ivec2> nextPoints;
+    for (int y = rectPixels.y - 1; y < rectPixels.y + rectPixels.h; ++y)
+    {
+        for (int x = rectPixels.x - 1; x < rectPixels.x + rectPixels.w; ++x)
+        {
+            const int caseIndex = (isSolid(x, y) ? 8 : 0) | (isSolid(x + 1, y) ? 4 : 0) |
+                (isSolid(x + 1, y + 1) ? 2 : 0) | (isSolid(x, y + 1) ? 1 : 0);
+
+            const auto& segments = caseSegments[caseIndex];
+            for (size_t i = 0; i < segments.size() && segments[i] != NoEdge; i += 2)
+            {
+                const glm::ivec2 cellOrigin{2 * x, 2 * y};
+                const glm::ivec2 start = cellOrigin + cellEdgeMiddles[segments[i]];
+                const glm::ivec2 end = cellOrigin + cellEdgeMiddles[segments[i + 1]];
+                nextPoints[PackPoint(start)] = end;
+            }
+        }
+    }
+
+    // Link segments into closed contours.
+    std::vector<std::vector<glm::vec2>> contours;
+    while (!nextPoints.empty())
+    {
+        glm::ivec2 current = UnpackPoint(nextPoints.begin()->first);
+        std::vector<glm::vec2> contour;
+
+        for (auto it = nextPoints.find(PackPoint(current)); it != nextPoints.end();
+             it = nextPoints.find(PackPoint(current)))
+        {
+            // Doubled coordinates of the pixel centers to the pixel coordinates.
+            contour.push_back(glm::vec2(current) / 2.0f + 0.5f);
+            current = it->second;
+            nextPoints.erase(it);
+        }
+
+        contours.push_back(std::move(contour));
+    }
+
+    return contours;
+}
+
+std::vector<glm::vec2> SimplifyClosedPolyline(const std::vector<glm::vec2>& polyline, float epsilon)
+{
+    const size_t n = polyline.size();
+    if (n < 3)
+        return {};
+
+    // Split the closed polyline into two open ones by the first vertex and the farthest one from it.
+    size_t farthestIndex = 0;
+    float farthestDistance = 0.0f;
+    for (size_t i = 1; i < n; ++i)
+    {
+        float distance = glm::distance(polyline[0], polyline[i]);
+        if (distance > farthestDistance)
+        {
+            farthestDistance = distance;
+            farthestIndex = i;
+        }
+    }
+
+    if (farthestIndex == 0)
+        return {};
+
+    // Index `n` is the same vertex as index 0. It closes the second half of the polyline.
+    auto point = [&](size_t index) -> const glm::vec2& { return polyline[index % n]; };
+
+    std::vector<bool> keep(n, false);
+    keep[0] = true;
+    keep[farthestIndex] = true;
+
+    std::vector<std::pair<size_t, size_t>> ranges = {{0, farthestIndex}, {farthestIndex, n}};
+    while (!ranges.empty())
+    {
+        auto [first, last] = ranges.back();
+        ranges.pop_back();
+
+        if (last - first < 2)
+            continue;
+
+        float maxDistance = 0.0f;
+        size_t maxDistanceIndex = first;
+        for (size_t i = first + 1; i < last; ++i)
+        {
+            float distance = DistanceToSegment(point(i), point(first), point(last));
+            if (distance > maxDistance)
+            {
+                maxDistance = distance;
+                maxDistanceIndex = i;
+            }
+        }
+
+        if (maxDistance > epsilon)
+        {
+            keep[maxDistanceIndex] = true;
+            ranges.emplace_back(first, maxDistanceIndex);
+            ranges.emplace_back(maxDistanceIndex, last);
+        }
+    }
+
+    std::vector<glm::vec2> simplified;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (keep[i])
+            simplified.push_back(polyline[i]);
+    }
+
+    if (simplified.size() < 3)
+        return {};
+
+    return simplified;
+}
+
+} // namespace utils
@@ -0,0 +1,21 @@
+#pragma once
+#include <SDL.h>
+#include <glm/glm.hpp>
+#include <utils/terrain/terrain_bitmap.h>
+#include <vector>
+
+namespace utils
+{
+
+// Trace closed contours of `solidPixel` pixels inside `rectPixels` with the marching squares algorithm.
+// Pixels outside of the rect are treated as empty, so every contour is closed inside the rect.
+// Contours are in the bitmap pixel coordinates. Walking along a contour the solid is always on the right side
+// (Y axis goes down). So normals of b2ChainShape created from the contour look outside of the solid.
+std::vector<std::vector<glm::vec2>> TraceTerrainContours(
+    const TerrainBitmap& bitmap, const SDL_Rect& rectPixels, TerrainBitmap::Pixel solidPixel);
+
+// Ramer-Douglas-Peucker simplification of the closed polyline. Orientation of the polyline is preserved.
+// Returns empty vector if the polyline degenerates to less than 3 vertices.
+std::vector<glm::vec2> SimplifyClosedPolyline(const std::vector<glm::vec2>& polyline, float epsilon);
+
+} // namespace utils
@@ -0,0 +1,55 @@
+#include "checks.h"
+#include <utils/animation_playback_pool.h>
+#include <vector>
+
+void CheckAnimationPlaybackPool(CheckResults& results)
+{
+    // Durations are powers of two, so the frame times are exact. Playback runs at the half of the speed factor.
+    const std::vector<float> frameDurations = {0.25f, 0.25f, 0.25f};
+    Animation clip;
+    clip.frames.resize(frameDurations.size());
+    clip.firstFrameInTable = 0;
+
+    AnimationPlaybackPool playbackPool(frameDurations);
+    const uint32_t loopedSlot = playbackPool.Acquire(clip);
+    const uint32_t onceSlot = playbackPool.Acquire(clip, false);
+
+    std::vector<size_t> loopedFrames;
+    std::vector<size_t> onceFrames;
+    for (int i = 0; i < 4; ++i)
+    {
+        playbackPool.Advance(0.5f);
+        loopedFrames.push_back(playbackPool.GetFrameIndex(loopedSlot));
+        onceFrames.push_back(playbackPool.GetFrameIndex(onceSlot));
+    }
+    results.Expect(
+        loopedFrames == std::vector<size_t>{1, 2, 0, 1}, "Playback: looped animation wraps to the first frame");
+    results.Expect(
+        onceFrames == std::vector<size_t>{1, 2, 0, 0}, "Playback: not looped animation stops on the first frame");
+    results.Expect(
+        playbackPool.IsPlaying(loopedSlot) && !playbackPool.IsPlaying(onceSlot),
+        "Playback: only the looped animation is playing after the wrap");
+
+    // Time left from the last frame is longer than the first frame. Stopped slot should not move on.
+    const std::vector<float> shortFirstFrameDurations = {0.125f, 0.5f};
+    Animation shortFirstFrameClip;
+    shortFirstFrameClip.frames.resize(shortFirstFrameDurations.size());
+    shortFirstFrameClip.firstFrameInTable = 0;
+    AnimationPlaybackPool shortFirstFramePool(shortFirstFrameDurations);
+    const uint32_t shortFirstFrameSlot = shortFirstFramePool.Acquire(shortFirstFrameClip, false);
+    std::vector<size_t> shortFirstFrames;
+    for (int i = 0; i < 4; ++i)
+    {
+        shortFirstFramePool.Advance(2.0f);
+        shortFirstFrames.push_back(shortFirstFramePool.GetFrameIndex(shortFirstFrameSlot));
+    }
+    results.Expect(
+        shortFirstFrames == std::vector<size_t>{1, 0, 0, 0}, "Playback: stopped animation stays on the first frame");
+
+    playbackPool.Release(onceSlot);
+    results.Expect(playbackPool.Acquire(clip) == onceSlot, "Playback: released slot is reused");
+    results.Expect(
+        playbackPool.GetFrameIndex(AnimationPlaybackPool::invalidSlot) == 0 &&
+            !playbackPool.IsPlaying(AnimationPlaybackPool::invalidSlot),
+        "Playback: invalid slot is a stopped first frame");
+}
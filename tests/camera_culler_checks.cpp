@@ -0,0 +1,96 @@
+#include "checks.h"
+#include <algorithm>
+#include <ecs/components/physics_components.h>
+#include <ecs/components/rendering_components.h>
+#include <entt/entt.hpp>
+#include <memory>
+#include <utils/game_options.h>
+#include <utils/render/camera_culler.h>
+#include <vector>
+
+void CheckCameraCuller(CheckResults& results)
+{
+    // Camera shows the world 1:1. With the margin of 8 world pixels from the config the visible rect is -8..72.
+    entt::registry registry;
+    auto& gameOptions = registry.emplace<GameOptions>(registry.create());
+    gameOptions.physicsWorld = std::make_shared<b2World>(gameOptions.gravity);
+    gameOptions.windowOptions.windowSize = {64, 64};
+    gameOptions.windowOptions.cameraCenterSdl = {32, 32};
+    CameraCuller culler(registry);
+
+    auto createRenderOnlyTile = [&registry](const glm::vec2& centerWorld, const glm::vec2& sizeWorld)
+    {
+        auto entity = registry.create();
+        TileComponent tileComponent;
+        tileComponent.sizeWorld = sizeWorld;
+        registry.emplace<TileComponent>(entity, tileComponent);
+        registry.emplace<RenderOnlyTileComponent>(entity, centerWorld);
+        return entity;
+    };
+    // Boxes of 16x16 world pixels with CoordinatesTransformer.box2DtoWorld = 16 from the config of the tests.
+    auto createBody = [&registry, &gameOptions](const std::vector<b2Vec2>& fixtureCentersPhysics)
+    {
+        auto entity = registry.create();
+        b2BodyDef bodyDef;
+        bodyDef.userData.pointer = static_cast<uintptr_t>(entity);
+        b2Body* body = gameOptions.physicsWorld->CreateBody(&bodyDef);
+        for (const auto& fixtureCenterPhysics : fixtureCentersPhysics)
+        {
+            b2PolygonShape shape;
+            shape.SetAsBox(0.5f, 0.5f, fixtureCenterPhysics, 0.0f);
+            body->CreateFixture(&shape, 1.0f);
+        }
+        registry.emplace<PhysicsComponent>(entity, std::make_shared<Box2dObjectRAII>(body, gameOptions.physicsWorld));
+        return entity;
+    };
+    auto isVisibleRenderOnlyTile = [&culler](entt::entity entity)
+    {
+        const auto& visibleTiles = culler.GetVisibleRenderOnlyTiles();
+        return std::find(visibleTiles.begin(), visibleTiles.end(), entity) != visibleTiles.end();
+    };
+
+    auto centerTile = createRenderOnlyTile({32, 32}, {16, 16});
+    auto marginTile = createRenderOnlyTile({76, 32}, {16, 16});
+    auto farTile = createRenderOnlyTile({100, 32}, {16, 16});
+    auto wideTile = createRenderOnlyTile({32, 100}, {128, 80});
+    auto visibleBody = createBody({{2.0f, 2.0f}});
+    auto twoFixturesBody = createBody({{1.0f, 1.0f}, {3.0f, 1.0f}});
+    auto farBody = createBody({{10.0f, 10.0f}});
+    culler.Update();
+
+    const auto& visibleTiles = culler.GetVisibleRenderOnlyTiles();
+    results.Expect(
+        isVisibleRenderOnlyTile(centerTile) && isVisibleRenderOnlyTile(marginTile) && !isVisibleRenderOnlyTile(farTile),
+        "Culler: render-only tiles are culled by the camera rect grown by the margin");
+    results.Expect(
+        std::count(visibleTiles.begin(), visibleTiles.end(), wideTile) == 1,
+        "Culler: tile covering several grid cells is reported once");
+
+    std::vector<entt::entity> expectedBodies = {visibleBody, twoFixturesBody};
+    std::sort(expectedBodies.begin(), expectedBodies.end());
+    results.Expect(
+        culler.GetVisibleBodies() == expectedBodies, "Culler: bodies are found once by the overlapping fixtures");
+    results.Expect(
+        culler.IsVisible(registry.get<PhysicsComponent>(visibleBody).bodyRAII->GetBody()) &&
+            !culler.IsVisible(registry.get<PhysicsComponent>(farBody).bodyRAII->GetBody()),
+        "Culler: body is visible if any of its fixtures overlaps the camera rect");
+
+    // Body is kept alive outside of the registry, so Box2D still reports it for the entity without the component.
+    auto detachedBodyRAII = registry.get<PhysicsComponent>(visibleBody).bodyRAII;
+    registry.remove<PhysicsComponent>(visibleBody);
+    registry.destroy(centerTile);
+    auto createdTile = createRenderOnlyTile({48, 48}, {16, 16});
+    culler.Update();
+    results.Expect(
+        culler.GetVisibleBodies() == std::vector<entt::entity>{twoFixturesBody},
+        "Culler: bodies of the entities without the physics component are skipped");
+    results.Expect(
+        !isVisibleRenderOnlyTile(centerTile) && isVisibleRenderOnlyTile(createdTile),
+        "Culler: grid is rebuilt when the render-only tiles are created or destroyed");
+
+    gameOptions.windowOptions.cameraCenterSdl = {132, 32};
+    culler.Update();
+    results.Expect(
+        isVisibleRenderOnlyTile(farTile) && !isVisibleRenderOnlyTile(createdTile) && culler.GetVisibleBodies().empty(),
+        "Culler: visible set follows the camera");
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <string_view>
+#include <utils/logger.h>
+
+// Failed checks are counted, so one run reports all of them.
+struct CheckResults
+{
+    size_t checksCount = 0;
+    size_t failedCount = 0;
+
+    void Expect(bool condition, std::string_view description)
+    {
+        checksCount++;
+        if (condition)
+            return;
+
+        failedCount++;
+        MY_LOG(error, "[Tests] Failed: {}", description);
+    }
+};
+
+void CheckTerrainContours(CheckResults& results);
+void CheckMergeOverlappingBlasts(CheckResults& results);
+void CheckSkylinePacker(CheckResults& results);
+void CheckAnimationPlaybackPool(CheckResults& results);
+void CheckLeastRecentlyUsedEviction(CheckResults& results);
+void CheckStaticTilesRenderCache(CheckResults& results);
+void CheckCameraCuller(CheckResults& results);
+void CheckTilesRenderQueue(CheckResults& results);
@@ -0,0 +1,37 @@
+#include "checks.h"
+#include <filesystem>
+#include <iostream>
+#include <my_cpp_utils/config.h>
+
+int main([[maybe_unused]] int argc, char* args[])
+{
+    try
+    {
+        // Config of the tests is copied next to the executable.
+        std::string execPath = args[0];
+        std::string execDir = execPath.substr(0, execPath.find_last_of("\\/"));
+        std::filesystem::current_path(execDir);
+
+        utils::Config::InitInstanceFromFile("config.json");
+        utils::Logger::Init(
+            "logs/wofares_game_engine_tests.log", utils::GetConfig<spdlog::level::level_enum, "main.logLevel">());
+
+        CheckResults results;
+        CheckTerrainContours(results);
+        CheckMergeOverlappingBlasts(results);
+        CheckSkylinePacker(results);
+        CheckAnimationPlaybackPool(results);
+        CheckLeastRecentlyUsedEviction(results);
+        CheckStaticTilesRenderCache(results);
+        CheckCameraCuller(results);
+        CheckTilesRenderQueue(results);
+
+        MY_LOG(info, "[Tests] Failed {} of {} checks", results.failedCount, results.checksCount);
+        return results.failedCount == 0 ? 0 : 1;
+    }
+    catch (const std::runtime_error& e)
+    {
+        std::cout << "Unhandled exception catched in tests: " << e.what() << std::endl;
+        return -1;
+    }
+}
@@ -0,0 +1,69 @@
+#include "checks.h"
+#include <ecs/components/rendering_components.h>
+#include <functional>
+#include <memory>
+#include <utils/render/render_queue.h>
+#include <utils/sdl/sdl_RAII.h>
+#include <vector>
+
+void CheckTilesRenderQueue(CheckResults& results)
+{
+    // Only the texture pointers are compared, so the textures are created by the software renderer.
+    SDLInitializerRAII sdlInitializer(0);
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, 1, 1, 32, SDL_PIXELFORMAT_ABGR8888);
+    if (!surface)
+        throw std::runtime_error(MY_FMT("[RenderQueueChecks] Failed to create the surface: {}", SDL_GetError()));
+    SDLSurfaceRAII frameSurface(surface);
+    SDLRendererRAII renderer(frameSurface.get());
+    auto createTexture = [&renderer]
+    {
+        return std::make_shared<SDLTextureRAII>(
+            SDL_CreateTexture(renderer.get(), SDL_PIXELFORMAT_ABGR8888, SDL_TEXTUREACCESS_STATIC, 1, 1));
+    };
+
+    auto makeTile = [](const std::shared_ptr<SDLTextureRAII>& texture, ZOrderingType zOrderingType)
+    {
+        TileComponent tileComponent;
+        tileComponent.texturePtr = texture;
+        tileComponent.zOrderingType = zOrderingType;
+        return tileComponent;
+    };
+    const auto firstTexture = createTexture();
+    const auto secondTexture = createTexture();
+    // Items are told apart by the center. Interleaved textures of one layer are the worst case for the batching.
+    const std::vector<TileComponent> tiles = {
+        makeTile(firstTexture, ZOrderingType::Terrain), makeTile(secondTexture, ZOrderingType::Background),
+        makeTile(secondTexture, ZOrderingType::Terrain), makeTile(firstTexture, ZOrderingType::Terrain),
+        makeTile(nullptr, ZOrderingType::Interiors), makeTile(secondTexture, ZOrderingType::Terrain)};
+
+    TilesRenderQueue renderQueue;
+    for (size_t i = 0; i < tiles.size(); ++i)
+        renderQueue.Push(tiles[i], {static_cast<float>(i), 0.0f}, 0.0f);
+    renderQueue.Sort();
+
+    auto getCenters = [&renderQueue](ZOrderingType zOrderingType)
+    {
+        std::vector<float> centers;
+        for (const auto& item : renderQueue.GetItems(zOrderingType))
+            centers.push_back(item.centerWorld.x);
+        return centers;
+    };
+    results.Expect(renderQueue.GetSize() == tiles.size(), "RenderQueue: every pushed tile is queued");
+    results.Expect(
+        getCenters(ZOrderingType::Background) == std::vector<float>{1.0f} &&
+            getCenters(ZOrderingType::Interiors) == std::vector<float>{4.0f},
+        "RenderQueue: tiles are bucketed by the z-order");
+
+    // Order of the groups depends on the texture addresses. Order inside of the group is the push order.
+    const bool isFirstTextureLess = std::less<SDL_Texture*>()(firstTexture->get(), secondTexture->get());
+    const std::vector<float> expectedTerrainCenters =
+        isFirstTextureLess ? std::vector<float>{0.0f, 3.0f, 2.0f, 5.0f} : std::vector<float>{2.0f, 5.0f, 0.0f, 3.0f};
+    results.Expect(
+        getCenters(ZOrderingType::Terrain) == expectedTerrainCenters,
+        "RenderQueue: layer is grouped by the texture and keeps the push order inside of the group");
+
+    renderQueue.Clear();
+    results.Expect(
+        renderQueue.GetSize() == 0 && renderQueue.GetItems(ZOrderingType::Terrain).empty(),
+        "RenderQueue: cleared queue is empty");
+}
@@ -0,0 +1,25 @@
+#include "checks.h"
+#include <utils/resources/resource_cache.h>
+#include <vector>
+
+void CheckLeastRecentlyUsedEviction(CheckResults& results)
+{
+    // Candidates come in the order of the hash maps, not of the uses.
+    std::vector<uint64_t> evictedLastUses;
+    std::vector<details::EvictionCandidate> candidates;
+    for (uint64_t lastUse : {5, 1, 4, 2})
+        candidates.push_back({lastUse, 10, [&evictedLastUses, lastUse] { evictedLastUses.push_back(lastUse); }});
+
+    size_t usedBytes = 45;
+    const size_t evictedCount = details::EvictLeastRecentlyUsed(candidates, usedBytes, 25);
+    results.Expect(
+        evictedLastUses == std::vector<uint64_t>{1, 2}, "Cache: the least recently used entries are evicted first");
+    results.Expect(evictedCount == 2 && usedBytes == 25, "Cache: eviction stops when the budget is met");
+
+    evictedLastUses.clear();
+    usedBytes = 100;
+    details::EvictLeastRecentlyUsed(candidates, usedBytes, 25);
+    results.Expect(
+        evictedLastUses.size() == candidates.size() && usedBytes == 60,
+        "Cache: all candidates are evicted if the budget is still exceeded");
+}
@@ -0,0 +1,110 @@
+#include "checks.h"
+#include <ecs/components/physics_components.h>
+#include <ecs/components/rendering_components.h>
+#include <entt/entt.hpp>
+#include <memory>
+#include <utils/game_options.h>
+#include <utils/render/static_tiles_render_cache.h>
+#include <utils/sdl/sdl_RAII.h>
+
+void CheckStaticTilesRenderCache(CheckResults& results)
+{
+    // Software renderer supports the render targets, so the chunks are really rendered and drawn to the surface.
+    SDLInitializerRAII sdlInitializer(0);
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, 64, 64, 32, SDL_PIXELFORMAT_ABGR8888);
+    if (!surface)
+        throw std::runtime_error(MY_FMT("[StaticTilesChecks] Failed to create the surface: {}", SDL_GetError()));
+    SDLSurfaceRAII frameSurface(surface);
+    SDLRendererRAII renderer(frameSurface.get());
+
+    // Camera shows the world 1:1, so the screen pixels are the world pixels.
+    entt::registry registry;
+    auto& gameOptions = registry.emplace<GameOptions>(registry.create());
+    gameOptions.physicsWorld = std::make_shared<b2World>(gameOptions.gravity);
+    gameOptions.windowOptions.windowSize = {64, 64};
+    gameOptions.windowOptions.cameraCenterSdl = {32, 32};
+    StaticTilesRenderCache staticTilesCache(registry, renderer.get());
+
+    auto createRenderOnlyTile = [&registry](const glm::vec2& centerWorld)
+    {
+        auto entity = registry.create();
+        TileComponent tileComponent;
+        tileComponent.sizeWorld = {16, 16};
+        registry.emplace<TileComponent>(entity, tileComponent);
+        registry.emplace<RenderOnlyTileComponent>(entity, centerWorld);
+        return entity;
+    };
+    // Body of 16x16 world pixels with CoordinatesTransformer.box2DtoWorld = 16 from the config of the tests.
+    auto createBodyTile = [&registry, &gameOptions](const b2Vec2& centerPhysics)
+    {
+        auto entity = registry.create();
+        b2BodyDef bodyDef;
+        bodyDef.position = centerPhysics;
+        b2Body* body = gameOptions.physicsWorld->CreateBody(&bodyDef);
+        b2PolygonShape shape;
+        shape.SetAsBox(0.5f, 0.5f);
+        body->CreateFixture(&shape, 1.0f);
+        TileComponent tileComponent;
+        tileComponent.sizeWorld = {16, 16};
+        registry.emplace<TileComponent>(entity, tileComponent);
+        registry.emplace<PhysicsComponent>(entity, std::make_shared<Box2dObjectRAII>(body, gameOptions.physicsWorld));
+        return entity;
+    };
+    auto renderFrame = [&renderer, &staticTilesCache]
+    {
+        SDL_SetRenderDrawColor(renderer.get(), 0, 0, 0, 0);
+        SDL_RenderClear(renderer.get());
+        staticTilesCache.Update();
+        staticTilesCache.Render(ZOrderingType::Terrain);
+    };
+    auto isPixelDrawn = [&renderer](int x, int y)
+    {
+        Uint32 pixel = 0;
+        const SDL_Rect pixelRect{x, y, 1, 1};
+        SDL_RenderReadPixels(renderer.get(), &pixelRect, SDL_PIXELFORMAT_ABGR8888, &pixel, sizeof(pixel));
+        return pixel != 0;
+    };
+
+    auto renderOnlyTile = createRenderOnlyTile({8, 8});
+    auto bodyTile = createBodyTile({2.5f, 2.5f});
+    renderFrame();
+    results.Expect(staticTilesCache.GetBakedTilesCount() == 2, "StaticTiles: render-only and static tiles are baked");
+    results.Expect(isPixelDrawn(8, 8) && isPixelDrawn(40, 40), "StaticTiles: baked tiles are drawn by the chunks");
+    results.Expect(!isPixelDrawn(24, 40), "StaticTiles: chunk is transparent between the tiles");
+
+    // Box2dBodyTuner reports the body type change with on_update<PhysicsComponent>.
+    auto body = registry.get<PhysicsComponent>(bodyTile).bodyRAII->GetBody();
+    body->SetType(b2_dynamicBody);
+    registry.patch<PhysicsComponent>(bodyTile);
+    renderFrame();
+    results.Expect(
+        staticTilesCache.GetBakedTilesCount() == 1 && !staticTilesCache.IsStaticTile(bodyTile),
+        "StaticTiles: tile with the body turned dynamic is not baked");
+    results.Expect(
+        isPixelDrawn(8, 8) && !isPixelDrawn(40, 40), "StaticTiles: chunk is re-rendered without the dynamic tile");
+
+    body->SetType(b2_staticBody);
+    registry.patch<PhysicsComponent>(bodyTile);
+    renderFrame();
+    results.Expect(
+        staticTilesCache.GetBakedTilesCount() == 2 && isPixelDrawn(40, 40),
+        "StaticTiles: tile with the body turned static is baked again");
+
+    // Device reset loses the textures of the chunks.
+    staticTilesCache.InvalidateAllChunks(true);
+    renderFrame();
+    results.Expect(
+        isPixelDrawn(8, 8) && isPixelDrawn(40, 40), "StaticTiles: chunks are recreated after the textures are lost");
+
+    registry.destroy(renderOnlyTile);
+    renderFrame();
+    results.Expect(
+        staticTilesCache.GetBakedTilesCount() == 1 && !isPixelDrawn(8, 8),
+        "StaticTiles: destroyed tile is removed from its chunks");
+
+    createRenderOnlyTile({8, 8});
+    renderFrame();
+    results.Expect(
+        staticTilesCache.GetBakedTilesCount() == 2 && isPixelDrawn(8, 8),
+        "StaticTiles: created tile is baked on the next update");
+}
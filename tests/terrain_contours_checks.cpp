@@ -0,0 +1,92 @@
+#include "checks.h"
+#include <glm/glm.hpp>
+#include <utils/terrain/terrain_bitmap.h>
+#include <utils/terrain/terrain_contours.h>
+#include <vector>
+
+namespace
+{
+
+// Positive if the polygon goes clockwise in the Y down coordinates.
+float GetSignedArea(const std::vector<glm::vec2>& polygon)
+{
+    float doubledArea = 0.0f;
+    for (size_t i = 0; i < polygon.size(); ++i)
+    {
+        const glm::vec2& current = polygon[i];
+        const glm::vec2& next = polygon[(i + 1) % polygon.size()];
+        doubledArea += current.x * next.y - next.x * current.y;
+    }
+    return doubledArea / 2.0f;
+}
+
+} // namespace
+
+void CheckTerrainContours(CheckResults& results)
+{
+    using Pixel = TerrainBitmap::Pixel;
+    auto fillRect = [](TerrainBitmap& bitmap, const SDL_Rect& rectPixels, Pixel pixel)
+    {
+        for (int y = rectPixels.y; y < rectPixels.y + rectPixels.h; ++y)
+        {
+            for (int x = rectPixels.x; x < rectPixels.x + rectPixels.w; ++x)
+                bitmap.SetPixel(x, y, pixel, 0xFFFFFFFF);
+        }
+    };
+    const SDL_Rect wholeRect{0, 0, 16, 16};
+
+    // Contour points lie in the middles of the pixel borders, so the corners of the block are cut by half a pixel.
+    {
+        TerrainBitmap bitmap({0.0f, 0.0f}, 16, 16, 8);
+        fillRect(bitmap, {2, 2, 3, 2}, Pixel::Destructible);
+        auto contours = utils::TraceTerrainContours(bitmap, wholeRect, Pixel::Destructible);
+        results.Expect(contours.size() == 1, "Contours: one contour around the block");
+        if (contours.size() == 1)
+        {
+            glm::vec2 minPos = contours[0].front();
+            glm::vec2 maxPos = contours[0].front();
+            for (const auto& point : contours[0])
+            {
+                minPos = glm::min(minPos, point);
+                maxPos = glm::max(maxPos, point);
+            }
+            results.Expect(
+                minPos == glm::vec2(2.0f, 2.0f) && maxPos == glm::vec2(5.0f, 4.0f),
+                "Contours: contour lies on the borders of the block");
+            results.Expect(GetSignedArea(contours[0]) == 5.5f, "Contours: solid is on the right side of the contour");
+        }
+    }
+
+    // Blocks split by an empty column and pixels touching by the corners are not connected.
+    {
+        TerrainBitmap bitmap({0.0f, 0.0f}, 16, 16, 8);
+        fillRect(bitmap, {1, 1, 2, 2}, Pixel::Destructible);
+        fillRect(bitmap, {4, 1, 2, 2}, Pixel::Destructible);
+        fillRect(bitmap, {8, 8, 1, 1}, Pixel::Destructible);
+        fillRect(bitmap, {9, 9, 1, 1}, Pixel::Destructible);
+        auto contours = utils::TraceTerrainContours(bitmap, wholeRect, Pixel::Destructible);
+        results.Expect(contours.size() == 4, "Contours: separate blocks and diagonal pixels get own contours");
+    }
+
+    // Only the pixels of the traced kind are solid.
+    {
+        TerrainBitmap bitmap({0.0f, 0.0f}, 16, 16, 8);
+        fillRect(bitmap, {2, 2, 4, 4}, Pixel::Indestructible);
+        auto contours = utils::TraceTerrainContours(bitmap, wholeRect, Pixel::Destructible);
+        results.Expect(contours.empty(), "Contours: indestructible pixels are not traced as destructible");
+    }
+
+    // Solid cut by the rect is closed on the border of the rect.
+    {
+        TerrainBitmap bitmap({0.0f, 0.0f}, 16, 16, 8);
+        fillRect(bitmap, wholeRect, Pixel::Destructible);
+        auto contours = utils::TraceTerrainContours(bitmap, {4, 4, 4, 4}, Pixel::Destructible);
+        bool isInsideRect = contours.size() == 1;
+        for (const auto& contour : contours)
+        {
+            for (const auto& point : contour)
+                isInsideRect &= point.x >= 4.0f && point.y >= 4.0f && point.x <= 8.0f && point.y <= 8.0f;
+        }
+        results.Expect(isInsideRect, "Contours: contour of the cut solid is closed inside the rect");
+    }
+}
@@ -0,0 +1,52 @@
+#include "checks.h"
+#include <utils/resources/texture_atlas.h>
+#include <vector>
+
+void CheckSkylinePacker(CheckResults& results)
+{
+    // Four quarters fill the page from the bottom left, nothing fits after them.
+    {
+        SkylinePacker packer(64, 64);
+        std::vector<SDL_Point> positions;
+        for (int i = 0; i < 4; ++i)
+        {
+            if (auto pos = packer.Insert(32, 32))
+                positions.push_back(*pos);
+        }
+        const bool isExpectedOrder = positions.size() == 4 && positions[0].x == 0 && positions[0].y == 0 &&
+            positions[1].x == 32 && positions[1].y == 0 && positions[2].x == 0 && positions[2].y == 32 &&
+            positions[3].x == 32 && positions[3].y == 32;
+        results.Expect(isExpectedOrder, "Packer: quarters are placed on the lowest segments first");
+        results.Expect(!packer.Insert(1, 1), "Packer: full page rejects the rect");
+    }
+
+    // Placed rects of mixed sizes stay inside the page and never overlap.
+    {
+        SkylinePacker packer(128, 128);
+        std::vector<SDL_Rect> placedRects;
+        const std::vector<SDL_Point> sizes = {
+            {40, 30}, {20, 50}, {64, 16}, {10, 10}, {30, 30}, {128, 8},
+            {50, 20}, {16, 64}, {33, 7}, {7, 33}, {60, 60}, {25, 25}};
+        for (const auto& size : sizes)
+        {
+            if (auto pos = packer.Insert(size.x, size.y))
+                placedRects.push_back({pos->x, pos->y, size.x, size.y});
+        }
+
+        bool isValid = !placedRects.empty();
+        for (size_t i = 0; i < placedRects.size(); ++i)
+        {
+            const SDL_Rect& rect = placedRects[i];
+            isValid &= rect.x >= 0 && rect.y >= 0 && rect.x + rect.w <= 128 && rect.y + rect.h <= 128;
+            for (size_t j = i + 1; j < placedRects.size(); ++j)
+            {
+                const SDL_Rect& other = placedRects[j];
+                const bool isOverlapped = rect.x < other.x + other.w && other.x < rect.x + rect.w &&
+                    rect.y < other.y + other.h && other.y < rect.y + rect.h;
+                isValid &= !isOverlapped;
+            }
+        }
+        results.Expect(isValid, "Packer: rects are inside the page and don't overlap");
+        results.Expect(!packer.Insert(129, 1), "Packer: rect wider than the page is rejected");
+    }
+}
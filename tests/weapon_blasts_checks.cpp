@@ -0,0 +1,45 @@
+#include "checks.h"
+#include <algorithm>
+#include <ecs/systems/weapon_control_system.h>
+#include <vector>
+
+void CheckMergeOverlappingBlasts(CheckResults& results)
+{
+    auto makeBlast = [](const b2Vec2& centerPhysics, float damageRadiusPhysics)
+    {
+        WeaponControlSystem::Blast blast;
+        blast.explosionEntity = entt::null;
+        blast.centerPhysics = centerPhysics;
+        blast.damageRadiusPhysics = damageRadiusPhysics;
+        blast.craterRadiusPhysics = damageRadiusPhysics;
+        blast.force = 0.0f;
+        return blast;
+    };
+
+    // Blasts 0, 1 and 3 are chained by the overlaps, 0 and 3 don't overlap directly. Blast 2 is alone.
+    const std::vector<WeaponControlSystem::Blast> blasts = {
+        makeBlast({0.0f, 0.0f}, 1.0f), makeBlast({1.5f, 0.0f}, 1.0f), makeBlast({10.0f, 0.0f}, 1.0f),
+        makeBlast({3.0f, 0.0f}, 1.0f)};
+    auto regions = WeaponControlSystem::MergeOverlappingBlasts(blasts);
+    results.Expect(regions.size() == 2, "Blasts: chain of overlapping blasts is merged into one region");
+
+    std::vector<size_t> mergedIndices;
+    bool isEveryBlastCovered = true;
+    for (auto& region : regions)
+    {
+        std::sort(region.blastIndices.begin(), region.blastIndices.end());
+        if (region.blastIndices.size() > 1)
+            mergedIndices = region.blastIndices;
+
+        for (size_t blastIndex : region.blastIndices)
+        {
+            const auto& blast = blasts[blastIndex];
+            const float farthestDistance =
+                b2Distance(region.centerPhysics, blast.centerPhysics) + blast.damageRadiusPhysics;
+            isEveryBlastCovered &= farthestDistance <= region.radiusPhysics + 1e-5f;
+        }
+    }
+    results.Expect(mergedIndices == std::vector<size_t>{0, 1, 3}, "Blasts: merged region has the chained blasts");
+    results.Expect(isEveryBlastCovered, "Blasts: region covers the damage circles of its blasts");
+    results.Expect(WeaponControlSystem::MergeOverlappingBlasts({}).empty(), "Blasts: no blasts give no regions");
+}